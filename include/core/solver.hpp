@@ -15,14 +15,51 @@
 #include "../util/intset.hpp"
 #include "../util/vector.hpp"
 #include "../util/occurence_list.hpp"
+#include "../util/heap.hpp"
+#include "../util/trace.hpp"
+#include "../util/proof.hpp"
 
 #include <queue>
 #include <stack>
 #include <functional>
 #include <iostream>
+#include <atomic>
+#include <chrono>
 
 namespace MyyuraSat {
 
+/**
+ * Branching heuristics:
+ *
+ * BRANCH_VSIDS     - Variable State Independent Decaying Sum, an activity heap
+ * BRANCH_VMTF      - Variable Move To Front, a queue ordered by bump time
+ * BRANCH_OCCURENCE - Pick the variable with most occurences (only for debugging)
+ */
+enum BranchHeuristic {
+    BRANCH_VSIDS,
+    BRANCH_VMTF,
+    BRANCH_OCCURENCE
+};
+
+/**
+ * Restart policies:
+ *
+ * RESTART_LUBY      - Restart after 'restart_first * luby(restart_inc, i)' 
+ * conflicts
+ * RESTART_GEOMETRIC - Restart after 'restart_first * restart_inc^i' conflicts
+ * RESTART_GLUCOSE   - Restart when the recent LBDs of learnt clauses are worse
+ * than the long time average, restarts are blocked when the trail is unusually
+ * large
+ */
+enum RestartPolicy {
+    RESTART_LUBY,
+    RESTART_GEOMETRIC,
+    RESTART_GLUCOSE
+};
+
+// The reason of a variable implied by an XOR matrix, until it is needed
+const CRARef CRAREF_LAZY = CRAREF_UNDEF - 1;
+
 class Solver {
 private:
     // List of problem clauses and learnt clauses
@@ -40,6 +77,16 @@ private:
     // The current assignments
     VMap<LiftedBoolean> _assigns;
 
+    /**
+     * The current assignments indexed by literal: 1 if the literal is true, 
+     * -1 if it is false and 0 if it is unassigned. Kept in sync with 
+     * '_assigns', so that the value of a literal is a single load and compare.
+     */
+    LMap<signed char> _values;
+
+    bool is_true(Literal p) const;
+    bool is_false(Literal p) const;
+
     /** 
      * Stores reason and level for each variable
      * If the current variable is a reason for a clause cr, then reason = cr.
@@ -55,11 +102,18 @@ private:
 
     VMap<_VariableInfo> _variable_info;
 
-    // '_watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true)
+    /**
+     * '_watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true)
+     * 
+     * For a binary clause the blocker is the other literal of the clause and
+     * never changes, so 'propagate' handles binary clauses from the watcher
+     * alone, without looking into the clause allocator.
+     */
     struct _Watcher {
         CRARef cref;
         Literal blocker;
-        _Watcher(CRARef cr, Literal p): cref(cr), blocker(p) {}
+        bool binary;
+        _Watcher(CRARef cr, Literal p, bool b = false): cref(cr), blocker(p), binary(b) {}
 
         bool operator==(const _Watcher& w) const { return cref == w.cref; }
         bool operator!=(const _Watcher& w) const { return cref != w.cref; }
@@ -106,17 +160,178 @@ private:
      */
     LSet _conflict;
 
-    // To see if a variable had been already checked
+    // The phase of each variable for the next decision: TRUE for the positive 
+    // literal. Saved when the variable is unassigned, kept across calls
     VMap<bool> _polarity;
-    
+
+    // Declares if a variable is eligible for selection in the decision heuristic
+    VMap<char> _decision;
+
+    /**
+     * VSIDS:
+     *
+     * '_activity[x]' - A heuristic measurement of the activity of variable x
+     * '_variable_inc' - Amount to bump next variable with
+     * '_variable_decay' - Inverse of the amount '_variable_inc' grows by 
+     * after each conflict
+     * '_order_heap' - A priority queue of variables ordered with respect to 
+     * the variable activity
+     */
+    VMap<double> _activity;
+    double _variable_inc;
+    double _variable_decay;
+
+    struct _VariableOrderLt {
+        const VMap<double>& activity;
+        bool operator()(Variable x, Variable y) const { return activity[x] > activity[y]; }
+        _VariableOrderLt(const VMap<double>& act) : activity(act) {}
+    };
+
+    Heap<Variable, _VariableOrderLt> _order_heap;
+
+    /**
+     * VMTF:
+     *
+     * All variables are kept in a doubly linked queue ordered by 'stamp', the
+     * time they were last enqueued. Bumping a variable moves it to the end of
+     * the queue.
+     * 
+     * '_vmtf_search' - Cached search pointer, every variable after it in the
+     * queue is assigned (or not a decision variable)
+     * '_vmtf_bumped' - Variables seen in the last conflict analysis
+     */
+    struct _VmtfLink {
+        Variable prev, next;
+        uint64_t stamp;
+
+        _VmtfLink() {}
+        _VmtfLink(Variable p, Variable n, uint64_t s) : prev(p), next(n), stamp(s) {}
+    };
+
+    VMap<_VmtfLink> _vmtf_links;
+    Variable _vmtf_first, _vmtf_last;
+    Variable _vmtf_search;
+    uint64_t _vmtf_stamp;
+    Vector<Variable> _vmtf_bumped;
+
+    void vmtf_enqueue(Variable x);
+    void vmtf_dequeue(Variable x);
+    void vmtf_bump_queue(void);
+
+    BranchHeuristic _branch_heuristic;
+
+    // Insert a variable in the decision order priority queue
+    void insert_variable_order(Variable x);
+
+    // Bump a variable seen in conflict analysis for the current heuristic
+    void variable_bump(Variable x);
+
+    // Increase a variable with the current 'bump' value
+    void variable_bump_activity(Variable x);
+
+    // Decay all variables with the specified factor. Implemented by increasing
+    // the 'bump' value instead
+    void variable_decay_activity(void);
 
     bool _myyura;
 
     // Statistics
     uint64_t _n_decision_variables, _n_clauses;
+    uint64_t _n_decisions, _n_conflicts, _n_propagations;
+    uint64_t _n_restarts, _n_blocked_restarts, _n_restart_trail;
+    uint64_t _n_max_literals, _n_total_literals;
+    uint64_t _n_subsumed, _n_strengthened, _n_eliminated;
+    uint64_t _n_failed_literals, _n_hyper_binaries, _n_substituted;
+    uint64_t _n_vivified, _n_vivified_literals;
+    uint64_t _n_blocked, _n_covered;
+    uint64_t _n_xors, _n_xor_propagations, _n_xor_conflicts;
+
+    /**
+     * Restarts:
+     *
+     * '_restart_first' - The initial restart limit
+     * '_restart_inc' - The factor with which the restart limit is multiplied 
+     * in each restart
+     * '_restart_index' - Index of the next restart limit (RESTART_LUBY and 
+     * RESTART_GEOMETRIC), kept when '_solve' runs out of budget so the next 
+     * call resumes the sequence
+     * '_lbd_fast', '_lbd_slow' - Fast and slow moving averages of the LBD of 
+     * learnt clauses (RESTART_GLUCOSE)
+     * '_trail_slow' - Slow moving average of the trail size at conflicts, used
+     * for blocking restarts (RESTART_GLUCOSE)
+     * '_lbd_window' - Conflicts since the last restart or blocked restart
+     */
+    struct _Ema {
+        double value;
+        double biased;
+        double exponent;
+        double alpha;
+
+        _Ema(double a) : value(0), biased(0), exponent(1), alpha(a) {}
+
+        // Exponential moving average with bias correction (as in ADAM)
+        void update(double x) {
+            biased += alpha * (x - biased);
+            exponent *= 1 - alpha;
+            value = biased / (1 - exponent);
+        }
+    };
+
+    RestartPolicy _restart_policy;
+    int _restart_first;
+    double _restart_inc;
+    int _restart_index;
+
+    _Ema _lbd_fast, _lbd_slow, _trail_slow;
+    int _lbd_window;
+    double _restart_margin;
+    double _restart_block;
+
+    // Literal block distance (number of distinct decision levels) of a clause
+    template<typename C>
+    int compute_lbd(const C& c);
+
+    Vector<uint64_t> _level_stamp;
+    uint64_t _lbd_stamp;
+
+    // Returns TRUE if the RESTART_GLUCOSE condition holds
+    bool restart_needed(void);
+
+    /**
+     * Learnt clause database:
+     *
+     * Learnt clauses are split into tiers by their LBD. Core clauses 
+     * ('lbd <= _core_lbd') are kept forever, tier2 clauses ('lbd <= _tier2_lbd')
+     * are kept as long as they are used between two reductions and the rest 
+     * (local) are only kept if they are active enough.
+     * 
+     * '_clause_inc' - Amount to bump next clause with
+     * '_clause_decay' - Inverse of the amount '_clause_inc' grows by after 
+     * each conflict
+     * '_next_reduce_db' - Number of conflicts at which 'reduce_db' runs next
+     * '_reduce_interval', '_reduce_inc' - The conflicts between reductions 
+     * grow arithmetically by '_reduce_inc'
+     */
+    double _clause_inc;
+    double _clause_decay;
+
+    uint32_t _core_lbd;
+    uint32_t _tier2_lbd;
+
+    uint64_t _next_reduce_db;
+    uint64_t _reduce_interval;
+    uint64_t _reduce_inc;
+    uint64_t _n_reduce_db, _n_removed_learnts;
+
+    void clause_bump_activity(Clause& c);
+    void clause_decay_activity(void);
+
+    // Reduce the set of learnt clauses
+    void reduce_db(void);
 
     // Return the next decision variable
     Literal pick_branch_literal(void);
+    Literal pick_branch_literal_occurence(void);
 
     // Begins a new decision level
     void new_decision_level(void);
@@ -136,6 +351,38 @@ private:
     // GRASP
     void analyze(CRARef conflict, Vector<Literal>& out_learnt, int& out_level);
 
+    // (helper method for 'analyze()')
+    bool literal_redundant(Literal p, uint32_t abstract_levels);
+
+    // The assumptions that made 'p' true, when an assumption is found false
+    void analyze_final(Literal p, LSet& out_conflict);
+
+    // Used to represent an abstraction of sets of decision levels
+    uint32_t abstract_level(Variable x) const;
+
+    /**
+     * Resource budgets (see 'within_budget'):
+     *
+     * '_conflict_budget', '_propagation_budget' - Stop when the number of 
+     * conflicts (propagations) reaches it, -1 if there is no budget
+     * '_memory_budget' - Stop when the clause database takes more bytes, 0 if 
+     * there is no budget
+     * '_time_budget' - Stop at this (wall-clock) time, if '_time_budget_on'
+     * '_budget_checks' - The clock is only read every 256 checks
+     * '_interrupted' - Set by 'interrupt', from a signal handler or another 
+     * thread
+     */
+    int64_t _conflict_budget;
+    int64_t _propagation_budget;
+    uint64_t _memory_budget;
+    bool _time_budget_on;
+    std::chrono::steady_clock::time_point _time_budget;
+    uint32_t _budget_checks;
+    std::atomic<bool> _interrupted;
+
+    // Returns FALSE if a budget is exhausted or the solver was interrupted
+    bool within_budget(void);
+
     // Search for a given number of conflicts
     LiftedBoolean search(int n_conflicts);
 
@@ -151,6 +398,9 @@ private:
     // Returns TRUE if a clause is a reason for some implication in the current state
     bool is_locked(const Clause& c) const;
 
+    // The literal a clause implies if it is a reason (usually the first literal)
+    Literal implied_literal(const Clause& c) const;
+
     // Returns LTRUE if a clause is satisfied in the current state
     LiftedBoolean is_satisfied(const Clause& c) const;
 
@@ -158,12 +408,47 @@ private:
     // Will change the passed vector ps
     bool _add_clause(Vector<Literal>& ps);
 
+    /**
+     * Bulk loading (see 'begin_bulk_load'):
+     * 
+     *  _bulk_load - Clauses are only normalized and stored, units are not 
+     * propagated yet
+     *  _bulk_start - Size of the clause region when the bulk load began, every
+     * clause from there on is still pending
+     *  _bulk_clauses - The pending clauses
+     */
+    bool _bulk_load;
+    CRARef _bulk_start;
+    Vector<CRARef> _bulk_clauses;
+
+    /**
+     * Scopes (see 'push' and 'pop'):
+     * 
+     *  _scopes - The activation literal of each open scope, innermost last. A 
+     * clause added in a scope gets the negation of its activation literal, and
+     * '_solve' assumes the activation literals of all open scopes
+     */
+    Vector<Literal> _scopes;
+
     // Gives the current decisionlevel
     int decision_level(void) const;
 
     CRARef reason(Variable x) const;
+    // The reason of 'x' as a clause, made now if it is 'CRAREF_LAZY'
+    CRARef reason_clause(Variable x);
     int level(Variable x) const;
 
+    /**
+     * Top-level simplification:
+     * 
+     * 'simplify_assigns' : Size of the trail at the last 'simplify' (-1 
+     * before the first one)
+     * 'simplify_propagations' : 'simplify' waits until the number of 
+     * propagations reaches this
+     */
+    int _simplify_assigns;
+    uint64_t _simplify_propagations;
+
     // Only used in toplevel
     void toplevel_simplify_satisfied_clause(Vector<CRARef>& cs);
 
@@ -175,6 +460,14 @@ private:
      * 'touched_list' - A list of the true elements in 'touched'
      * 'added' : Clauses created
      * 'strengthened' : Clauses strengthened
+     * 'subsumption_effort' : Occurence list visits allowed per call of 
+     * 'eliminate', i.e. before each search (0 turns subsumption off)
+     * 'subsumption_head' : Top-level assignments on the trail before this 
+     * index are already applied to the problem clauses
+     * 'subsumption_queue' : Clauses left unchecked when the effort ran out 
+     * (marked with 2), checked first by the next call
+     * 'subsumption_removed' : Clauses removed during the current pass, their
+     * occurence lists are cleaned at the end of it
      */
     OccurenceList<Literal, CRARef, Vector<CRARef>, LiteralIndexDefault> _occur_lit;
 
@@ -185,20 +478,265 @@ private:
     Vector<Variable> _touched_list;
     CSet _added;
     CSet _strengthened;
+    int64_t _subsumption_effort;
+    int _subsumption_head;
+    Vector<CRARef> _subsumption_queue;
+    Vector<CRARef> _subsumption_removed;
 
     bool is_subsumed(CRARef cr);
+    void subsume_batch(Vector<CRARef>& cs);
     void subsume0(CRARef cr);
-    void subsume1(CRARef cr);
+    bool subsume1(CRARef cr, int64_t& effort);
+    bool strengthen_clause(CRARef cr, Literal p, uint64_t by);
     void touch(const Variable& x);
     void touch(const Literal& p);
-    void reduction_by_subsumption(void);
+    bool reduction_by_subsumption(int64_t& effort);
+
+    /**
+     * Variable elimination:
+     * 
+     * 'elimination' : Eliminate variables before each search
+     * 'frozen' : Never eliminated, 1 - by 'frozen', 2 - assumed in the 
+     * current call, 4 - in an XOR matrix
+     * 'eliminated' : Index of the variable's record in 'elim_records' (-1 if 
+     * the variable is not eliminated)
+     * 'elim_records' : One per eliminated variable, in the order they were 
+     * eliminated. The clauses removed with the variable are 'elim_clauses' 
+     * [begin, end), each one as its size followed by its literals. A record 
+     * whose variable was restored has 'x == VARIABLE_UNDEF'. A 'blocked' 
+     * record is a removed blocked clause instead (see 
+     * 'eliminate_blocked_clause'), the variable stays.
+     * 'elim_touched' : Variables whose occurences changed since they were 
+     * last tried (also true initially)
+     * 'elim_grow' : A variable is eliminated if it has at most this many 
+     * resolvents more than clauses
+     * 'elim_clause_limit' : No resolvent may be longer
+     * 'elim_occurence_limit' : Variables in more clauses are not tried
+     * 'elimination_effort' : Resolution steps allowed per call of 'eliminate'
+     */
+    struct _Elimination {
+        Variable x;
+        int begin, end;
+        bool blocked;
+        _Elimination(Variable v, int b, int e, bool bl = false): x(v), begin(b), end(e), blocked(bl) {}
+    };
+
+    bool _elimination;
+    VMap<char> _frozen;
+    VMap<int> _eliminated;
+    Vector<_Elimination> _elim_records;
+    Vector<uint32_t> _elim_clauses;
+    VMap<bool> _elim_touched;
+    Vector<Variable> _elim_touched_list;
+    int _elim_grow;
+    int _elim_clause_limit;
+    int _elim_occurence_limit;
+    int64_t _elimination_effort;
+
+    bool is_eliminable(Variable x) const;
+    int resolvent(const Clause& c, const Clause& d, Variable x, Vector<Literal>& out);
+    bool add_resolvent(Vector<Literal>& ps, uint64_t c_id, uint64_t d_id);
+    bool eliminate_variable(Variable x, int64_t& effort);
+    bool eliminate(void);
+    void restore_variable(Variable x);
+    void extend_model(void);
+    void decision(Variable x, bool b);
+
+    /**
+     * Blocked clause elimination:
+     * 
+     * 'blocked_elimination' : Remove blocked problem clauses in 'eliminate'
+     * 'covered_elimination' : Also remove the clauses that are blocked after
+     * covered literal addition
+     * 'witness' : Number of blocked records with a witness on the variable, 
+     * the model may flip it
+     * 'cover_limit' : Covered literal addition stops at this clause size
+     * 'blocked_effort' : Occurence list visits allowed per call of 'eliminate'
+     * 'cover_literals' : The clause being extended, 'cover_common' the 
+     * literals common to its resolvents
+     */
+    bool _blocked_elimination;
+    bool _covered_elimination;
+    VMap<int> _witness;
+    int _cover_limit;
+    int64_t _blocked_effort;
+    Vector<Literal> _cover_literals;
+    Vector<Literal> _cover_common;
+    Vector<int> _cover_steps;
+
+    bool is_extended(Variable x) const;
+    bool eliminate_blocked_clause(CRARef cr, int64_t& effort);
+    void eliminate_blocked(int64_t& effort);
+    void restore_blocked(Variable x);
+
+    /**
+     * Probing:
+     * 
+     * 'probing' : Probe periodically during the search
+     * 'next_probe' : Number of conflicts at which 'probe' (and 'vivify') runs
+     * next
+     * 'probe_interval' : Conflicts between two probing rounds
+     * 'probe_ratio' : A round may take this fraction of the propagations of
+     * the search since the last one, but at least 'probe_min_ticks' (the 
+     * same for the vivification after it)
+     * 'probe_propagations' : Propagations when the last round ended
+     * 'probe_next' : Literal (as an index) the next round starts from
+     * 'probe_parent', 'probe_depth' : Binary implication tree of the current
+     * probe, see 'hyper_binary_resolution'
+     * 'probe_phases' : Saved phases, see 'cancel_keeping_phases'
+     */
+    bool _probing;
+    uint64_t _next_probe;
+    uint64_t _probe_interval;
+    double _probe_ratio;
+    uint64_t _probe_min_ticks;
+    uint64_t _probe_propagations;
+    int _probe_next;
+    LMap<Literal> _probe_parent;
+    VMap<int> _probe_depth;
+    Vector<Literal> _probe_phases;
+
+    void cancel_keeping_phases(void);
+    void hyper_binary_resolution(Vector<int>& implied, int epoch);
+    bool probe(uint64_t ticks);
+
+    // Equivalent literal substitution, the replaced variables are kept as 
+    // eliminated ones (see 'substitute')
+    void binary_components(Vector<int>& component, Vector<Literal>& members, Vector<int>& begins);
+    bool substitute(void);
+
+    /**
+     * Vivification (see 'vivify'):
+     * 
+     * 'vivification' : Vivify clauses after each probing round
+     * 'vivify_next' : Index of the problem clause the next round starts from
+     * 'vivify_literals' : The literals of the clause being vivified
+     */
+    bool _vivification;
+    int _vivify_next;
+    Vector<Literal> _vivify_literals;
+
+    bool vivify_clause(CRARef cr);
+    bool vivify(uint64_t ticks);
+
+    /**
+     * XOR constraints (see solver_gauss.cpp):
+     *
+     * 'gauss' : Extract the XOR constraints before the first search and
+     * propagate them by Gauss-Jordan elimination (not while writing a proof)
+     * 'xor_extracted' : The extraction has run
+     * 'xor_size_limit' : XOR constraints of more variables are not extracted
+     * (one of k variables takes 2^(k-1) clauses)
+     * 'xor_column_limit' : Larger components of XOR constraints get no matrix
+     * 'xor_matrices' : One matrix per connected component
+     * 'xor_matrix', 'xor_column' : The matrix and the column of a variable
+     * (-1 if it has none)
+     * 'xor_head' : The variables on the trail before this index are assigned
+     * in their matrix
+     * 'xor_implied' : Variables implied by a matrix at a decision level, in
+     * trail order. Their reason is 'CRAREF_LAZY' until 'analyze' needs it,
+     * then a clause made from the copy of the row in 'xor_row_copies' (see
+     * 'xor_reason'), which is freed when they are unassigned (also
+     * 'xor_conflict')
+     * 'xor_implied_index' : The index of a variable in 'xor_implied'
+     * 'xor_stamp' : Marks the rows visited for the current variable
+     */
+    struct _XorMatrix {
+        int n_words;
+        Vector<Variable> columns;
+        // Row 'r' is the words [r * n_words, (r + 1) * n_words), a bit per column
+        Vector<uint64_t> rows;
+        Vector<char> rhs;
+        // Each row watches its basic column (in no other row) and one more
+        Vector<int> basic;
+        Vector<int> watch;
+        Vector<uint64_t> stamp;
+        Vector<Vector<int>> watches;
+        // The columns assigned in the matrix and the ones of them that are true
+        Vector<uint64_t> assigned;
+        Vector<uint64_t> values;
+
+        int n_rows(void) const { return basic.size(); }
+        uint64_t *row(int r) { return &rows[r * n_words]; }
+    };
+
+    struct _XorImplied {
+        Variable x;
+        int row;
+        int rhs;
+        CRARef reason;
+
+        _XorImplied(Variable x, int row, int rhs) : x(x), row(row), rhs(rhs), reason(CRAREF_UNDEF) {}
+    };
+
+    bool _gauss;
+    bool _xor_extracted;
+    int _xor_size_limit;
+    int _xor_column_limit;
+    Vector<_XorMatrix> _xor_matrices;
+    VMap<int> _xor_matrix;
+    VMap<int> _xor_column;
+    int _xor_head;
+    Vector<_XorImplied> _xor_implied;
+    VMap<int> _xor_implied_index;
+    Vector<uint64_t> _xor_row_copies;
+    CRARef _xor_conflict;
+    uint64_t _xor_stamp;
+    Vector<int> _xor_rows;
+    Vector<int> _xor_pivoted;
+    Vector<Literal> _xor_literals;
+
+    bool add_xor_matrix(const Vector<Variable>& vars, const Vector<int>& begins, const Vector<char>& rhs);
+    bool extract_xors(void);
+    CRARef xor_clause(_XorMatrix& m, const uint64_t *row, int rhs, int implied);
+    CRARef xor_reason(Variable x);
+    void xor_pivot(_XorMatrix& m, int r, int y, int c);
+    CRARef xor_update_row(_XorMatrix& m, int r, int c);
+    CRARef propagate_xors(void);
+    void cancel_xors(int level);
 
     /**
      * Temporaries (to reduce allocation overhead)
      */
     VMap<char> _seen;
+    Vector<Literal> _analyze_stack;
+    Vector<Literal> _analyze_toclear;
     Vector<Literal> _add_clause_temp;
 
+    /**
+     * Proof output (see include/util/proof.hpp and solver_proof.cpp):
+     * 
+     *  _proof - NULL unless a proof is written
+     *  _next_problem_id - Id of the next problem clause, problem clauses are 
+     * numbered in the order they are added (starting at 1)
+     *  _problem_ids_end - Problem clause ids are below this, fixed by the first 
+     * derived clause unless declared (see 'proof_problem_clauses')
+     *  _next_clause_id - Id of the next derived clause (0 before the first)
+     *  _unit_id - The id of the unit clause of each top-level assignment (0 
+     * if it has none yet)
+     *  _proof_units_head - Top-level assignments on the trail before this 
+     * index have a unit id
+     *  _proof_hints - Antecedents of the next clause added to the proof
+     */
+    Proof *_proof;
+    uint64_t _next_problem_id;
+    uint64_t _problem_ids_end;
+    uint64_t _next_clause_id;
+    VMap<uint64_t> _unit_id;
+    int _proof_units_head;
+    Vector<uint64_t> _proof_hints;
+    Vector<uint64_t> _proof_chain;
+    Vector<Literal> _proof_literals;
+
+    bool lrat(void) const;
+    uint64_t new_clause_id(void);
+    void proof_add(const Literal *lits, int n, uint64_t id);
+    void proof_remove(const Clause& c);
+    void proof_units(void);
+    void proof_chain(CRARef conflict, const Vector<Literal>& learnt);
+    void proof_empty_clause(CRARef conflict);
+    void proof_strengthen(CRARef cr, Literal p, uint64_t by);
+
     /**
      * Garbage collection:
      * 
@@ -209,6 +747,9 @@ private:
     virtual void garbage_collect(void);
     double _garbage_frac;
 
+    // Debug trace of propagate/analyze/search/GC (empty unless MYYURASAT_TRACE)
+    Tracer _trace;
+
 public:
     // Constructor & Destructor
     Solver(void);
@@ -220,6 +761,36 @@ public:
     // Make literal true and promise to never refer to variable again
     void release_variable(Literal l);
 
+    // Size hint before adding a problem with n_clauses clauses of n_literals 
+    // literals in total
+    void reserve(int n_clauses, uint64_t n_literals);
+
+    // Binary cache of the problem clauses and top-level trail (see 
+    // solver_cache.cpp), 'input' is the file the problem was read from
+    bool save_cache(const char *path, const char *input = NULL) const;
+    bool load_cache(const char *path, const char *input = NULL);
+
+    // Add many clauses at once: between these two calls 'add_clause' only 
+    // stores the clauses, subsumption and watches are done in one pass at the
+    // end
+    void begin_bulk_load(void);
+    void end_bulk_load(void);
+
+    // Open a scope: the clauses added until the matching 'pop' are removed by
+    // it, together with the learnt clauses derived from them. 'pop' closes 
+    // the innermost 'n_scopes' scopes.
+    void push(void);
+    void pop(int n_scopes = 1);
+    int n_scopes(void) const;
+
+    // Write a proof of unsatisfiability to 'out', must be called before any 
+    // clause is added
+    void proof(FILE *out, ProofFormat format = PROOF_DRAT);
+
+    // Number of problem clauses that will be added (LRAT numbers the derived 
+    // clauses after them), e.g. from the DIMACS header
+    void proof_problem_clauses(int n);
+
     // Add a clause to the solver
     bool add_clause(const Vector<Literal>& ps);
     bool add_clause(Literal p);
@@ -228,7 +799,8 @@ public:
     bool add_clause(Literal p, Literal q, Literal r, Literal s);
     bool add_empty_clause(void);
 
-    // Removes already satisfied clauses
+    // Removes already satisfied clauses and false literals, when the top 
+    // level grew since the last call (also called by the search)
     bool simplify(void);
 
     // Search for a model that respects a given set of assumptions
@@ -246,6 +818,20 @@ public:
     // Search without assumptions
     bool solve(void);
 
+    // Budgets for 'solve_limited', counted from now on. Negative (0 for the 
+    // memory budget) means no budget. The memory budget is for the clause 
+    // database, in bytes.
+    void conflict_budget(int64_t n);
+    void propagation_budget(int64_t n);
+    void memory_budget(uint64_t bytes);
+    void time_budget(double seconds);
+    void budget_off(void);
+
+    // Make 'solve_limited' return LIFTED_BOOLEAN_UNDEF as soon as possible, 
+    // async-signal-safe. The flag stays set until 'clear_interrupt'.
+    void interrupt(void);
+    void clear_interrupt(void);
+
     // Iterate over clauses and top-level assignments
     // ClauseIterator clauses_begin(void) const;
     // ClauseIterator clauses_end(void) const;
@@ -267,6 +853,12 @@ public:
     // have been satisfiable.
     LiftedBoolean model_value(Literal p) const;
 
+    // If the last call to solve was unsatisfiable under the assumptions, the 
+    // negations of the assumptions it depends on. Empty if the problem is 
+    // unsatisfiable without them (or, with open scopes, if the clauses of the 
+    // scopes are)
+    const LSet& conflict(void) const;
+
     // The current number of assigned literals
     int n_assigns(void) const;
 
@@ -290,13 +882,55 @@ public:
     void check_garbage(void);
     void check_garbage(double gf);
 
+    // Tracing (only in builds with MYYURASAT_TRACE)
+    void trace(int level, unsigned categories = TRACE_ALL);
+    void dump_trace(FILE *out) const;
+
     // Mode of operation
+    void branch_heuristic(BranchHeuristic h);
+    void restart_policy(RestartPolicy p);
+
+    // Occurence list visits allowed for subsumption before each search (0 
+    // turns it off)
+    void subsumption_effort(int64_t visits);
+
+    // Bounded variable elimination before each search and equivalent literal
+    // substitution (on by default). A frozen variable is never eliminated, an
+    // eliminated one is put back when it is used in a new clause, assumed or 
+    // frozen.
+    void elimination(bool on);
+    void frozen(Variable x, bool b);
+    bool is_eliminated(Variable x) const;
+
+    // Blocked clause elimination before each search, optionally with covered
+    // clause elimination (both on by default, and only with 'elimination'). 
+    // A clause removed this way is put back when a variable it may flip in 
+    // the model is used in a new clause, assumed or frozen.
+    void blocked_elimination(bool on);
+    void covered_elimination(bool on);
+
+    // Failed literal probing with hyper-binary resolution during the search
+    // (on by default)
+    void probing(bool on);
+
+    // Vivification of learnt and problem clauses during the search (on by 
+    // default)
+    void vivification(bool on);
+
+    // Gauss-Jordan elimination on the XOR constraints found in the problem
+    // clauses before the first search (on by default, off while writing a 
+    // proof). The clauses stay, the matrices only propagate more.
+    void gaussian_elimination(bool on);
 
     // Only for debugging
     bool solve_test(void);
     void clause_test(void);
     void garbage_collection_test(void);
     void subsumption_test(void);
+    bool cache_test(void);
+    void branch_benchmark(BranchHeuristic h);
+    void propagation_benchmark(uint64_t n_propagations);
+    void xor_benchmark(int n_variables, int n_xors, uint32_t seed);
 };
 
 }
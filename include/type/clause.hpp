@@ -29,30 +29,49 @@ using CSet = std::unordered_set<CRARef>;
 class Clause {
 private:
     /**
-     * mark : clause is removed (1)
+     * mark : clause is removed (1), queued by reduction_by_subsumption (2)
      */
     struct {
         unsigned mark      : 2;
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned size      : 27; 
+        unsigned has_id    : 1;
+        unsigned size      : 26; 
     } _header;
 
+    /**
+     * The extra field(s) follow the literals: 'abst' for a problem clause, 
+     * 'act' and then 'glue' for a learnt clause. The 64-bit proof id (LRAT) 
+     * takes the last two words, if any.
+     */
     union {
         Literal lit;
         float act;
         uint32_t abst;
+        struct {
+            unsigned lbd      : 30;
+            unsigned used     : 1;
+            unsigned vivified : 1;
+        } glue;
         CRARef rel;
     } _data[0];
 
     friend class ClauseAllocator;
 
-    Clause(const Vector<Literal>& ps, bool use_extra, bool learnt) {
+    // Number of words after the literals
+    int extra_words(void) const {
+        return (_header.has_extra ? (_header.learnt ? 2 : 1) : 0) + (_header.has_id ? 2 : 0);
+    }
+
+    int id_index(void) const { return _header.size + (_header.has_extra ? (_header.learnt ? 2 : 1) : 0); }
+
+    Clause(const Vector<Literal>& ps, bool use_extra, bool learnt, bool use_id) {
         _header.mark = 0;
         _header.learnt = learnt;
         _header.has_extra = use_extra;
         _header.reloced = 0;
+        _header.has_id = use_id;
         _header.size = ps.size();
 
         for (int i = 0; i < ps.size(); i++) {
@@ -62,16 +81,22 @@ private:
         if (_header.has_extra) {
             if (_header.learnt) {
                 _data[_header.size].act = 0;
+                _data[_header.size + 1].glue.lbd = 0;
+                _data[_header.size + 1].glue.used = 0;
+                _data[_header.size + 1].glue.vivified = 0;
             } else {
                 calc_abstraction();
             }
         }
+
+        if (_header.has_id) { id(0); }
     }
 
-    Clause(const Clause& from, bool use_extra) {
+    Clause(const Clause& from, bool use_extra, bool use_id) {
         _header = from._header;
         _header.has_extra = use_extra;
-        // NOTE: the copied clause may lose the extra field.
+        _header.has_id = use_id;
+        // NOTE: the copied clause may lose the extra field (or the id).
 
         for (int i = 0; i < from.size(); i++) {
             _data[i].lit = from[i];
@@ -80,10 +105,13 @@ private:
         if (_header.has_extra) {
             if (_header.learnt) {
                 _data[_header.size].act = from._data[_header.size].act;
+                _data[_header.size + 1].glue = from._data[_header.size + 1].glue;
             } else {
                 _data[_header.size].abst = from._data[_header.size].abst;
             }
         }
+
+        if (_header.has_id) { id(from._header.has_id ? from.id() : 0); }
     }
 
 public:
@@ -107,8 +135,9 @@ public:
             throw std::out_of_range("Clause::shrink : out of size");
         }
 
-        if (_header.has_extra) {
-            _data[_header.size - i] = _data[_header.size];
+        // Move the extra fields (and the id) after the remaining literals
+        for (int k = 0, n = extra_words(); k < n; k++) {
+            _data[_header.size - i + k] = _data[_header.size + k];
         }
 
         _header.size -= i;
@@ -127,6 +156,26 @@ public:
 
     bool has_extra(void) const { return _header.has_extra; }
 
+    bool has_id(void) const { return _header.has_id; }
+
+    // Clause id in the proof (LRAT)
+    uint64_t id(void) const {
+        if (CHECKS_ENABLED && !_header.has_id) {
+            throw std::logic_error("Clause::id : no id");
+        }
+
+        return (uint64_t)_data[id_index()].abst | ((uint64_t)_data[id_index() + 1].abst << 32);
+    }
+
+    void id(uint64_t x) {
+        if (CHECKS_ENABLED && !_header.has_id) {
+            throw std::logic_error("Clause::id : no id");
+        }
+
+        _data[id_index()].abst = (uint32_t)x;
+        _data[id_index() + 1].abst = (uint32_t)(x >> 32);
+    }
+
     uint32_t mark(void) const { return _header.mark; }
 
     void mark(uint32_t m) { _header.mark = m; }
@@ -153,15 +202,62 @@ public:
     operator const Literal* (void) const { return (Literal*)_data; }
 
     float& activity(void) {
-        if (!_header.has_extra) {
+        if (CHECKS_ENABLED && !_header.has_extra) {
+            throw std::logic_error("Clause::activity : no extras");
+        }
+
+        return _data[_header.size].act;
+    }
+
+    float activity(void) const {
+        if (CHECKS_ENABLED && !_header.has_extra) {
             throw std::logic_error("Clause::activity : no extras");
         }
 
         return _data[_header.size].act;
     }
 
+    // Literal block distance, only for learnt clauses
+    uint32_t lbd(void) const {
+        if (CHECKS_ENABLED && !_header.learnt) {
+            throw std::logic_error("Clause::lbd : not a learnt clause");
+        }
+
+        return _data[_header.size + 1].glue.lbd;
+    }
+
+    void lbd(uint32_t l) {
+        if (CHECKS_ENABLED && !_header.learnt) {
+            throw std::logic_error("Clause::lbd : not a learnt clause");
+        }
+
+        _data[_header.size + 1].glue.lbd = l;
+    }
+
+    // Set when the learnt clause took part in a conflict since the last reduction
+    bool used(void) const { return _header.learnt && _data[_header.size + 1].glue.used; }
+
+    void used(bool u) {
+        if (CHECKS_ENABLED && !_header.learnt) {
+            throw std::logic_error("Clause::used : not a learnt clause");
+        }
+
+        _data[_header.size + 1].glue.used = u;
+    }
+
+    // Set when the learnt clause was tried by 'vivify'
+    bool vivified(void) const { return _header.learnt && _data[_header.size + 1].glue.vivified; }
+
+    void vivified(bool v) {
+        if (CHECKS_ENABLED && !_header.learnt) {
+            throw std::logic_error("Clause::vivified : not a learnt clause");
+        }
+
+        _data[_header.size + 1].glue.vivified = v;
+    }
+
     uint32_t abstraction(void) const {
-        if (!_header.has_extra) {
+        if (CHECKS_ENABLED && !_header.has_extra) {
             throw std::logic_error("Clause::abstraction : no extras");
         }
 
@@ -238,20 +334,25 @@ class ClauseAllocator {
 private:
     RegionAllocator<uint32_t> _ra;
     bool _extra_clause_field;
+    bool _clause_ids;
 
-    uint32_t clause_word32size(int size, bool has_extra) {
-        return (sizeof(Clause) + (sizeof(Literal) * (size + (int)has_extra))) / sizeof(uint32_t);
+    // A learnt clause has two extra fields (activity and glue), others at most
+    // one, plus two words for the id
+    uint32_t clause_word32size(int size, bool has_extra, bool learnt, bool has_id = false) {
+        int extras = (has_extra ? (learnt ? 2 : 1) : 0) + (has_id ? 2 : 0);
+        return (sizeof(Clause) + (sizeof(Literal) * (size + extras))) / sizeof(uint32_t);
     }
 
 public:
     static const std::size_t UNIT_SIZE = RegionAllocator<uint32_t>::UNIT_SIZE;
 
-    ClauseAllocator(uint32_t start_cap) : _ra(start_cap), _extra_clause_field(true) {}
+    ClauseAllocator(uint32_t start_cap) : _ra(start_cap), _extra_clause_field(true), _clause_ids(false) {}
 
-    ClauseAllocator(void) : _extra_clause_field(true) {}
+    ClauseAllocator(void) : _extra_clause_field(true), _clause_ids(false) {}
 
     void move_to(ClauseAllocator& to) {
         to._extra_clause_field = _extra_clause_field;
+        to._clause_ids = _clause_ids;
         _ra.move_to(to._ra);
     }
 
@@ -261,22 +362,35 @@ public:
         }
 
         bool use_extra = learnt | _extra_clause_field;
-        CRARef cid = _ra.alloc(clause_word32size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt);
+        CRARef cid = _ra.alloc(clause_word32size(ps.size(), use_extra, learnt, _clause_ids));
+        new (lea(cid)) Clause(ps, use_extra, learnt, _clause_ids);
 
         return cid;
     }
 
     CRARef alloc(const Clause& from) {
         bool use_extra = from.learnt() | _extra_clause_field;
-        CRARef cid = _ra.alloc(clause_word32size(from.size(), use_extra));
-        new (lea(cid)) Clause(from, use_extra);
+        CRARef cid = _ra.alloc(clause_word32size(from.size(), use_extra, from.learnt(), _clause_ids));
+        new (lea(cid)) Clause(from, use_extra, _clause_ids);
         return cid;
     }
 
     uint32_t size(void) const { return _ra.size(); }
     uint32_t wasted(void) const { return _ra.wasted(); }
 
+    // Make room for n_clauses problem clauses with n_literals literals in total
+    void reserve(uint64_t n_clauses, uint64_t n_literals) {
+        uint64_t words = n_literals + n_clauses * (clause_word32size(0, _extra_clause_field, false, _clause_ids));
+        _ra.reserve((uint32_t)std::min(words, (uint64_t)std::numeric_limits<uint32_t>::max() - 1));
+    }
+
+    // Copy 'size' raw words of clauses (e.g. a region written out before), the
+    // references inside the copy are offset by the returned reference
+    CRARef append(const uint32_t *words, uint32_t size) { return _ra.append(words, size); }
+
+    // Raw words of the region (size() words)
+    const uint32_t *data(void) const { return size() == 0 ? NULL : _ra.lea(0); }
+
     Clause& operator[](CRARef r) { return (Clause&)_ra[r]; }
     const Clause& operator[](CRARef r) const { return (Clause&)_ra[r]; }
 
@@ -285,7 +399,7 @@ public:
 
     void free(CRARef cid) {
         Clause& c = operator[](cid);
-        _ra.free(clause_word32size(c.size(), c.has_extra()));
+        _ra.free(clause_word32size(c.size(), c.has_extra(), c.learnt(), c.has_id()));
     }
 
     void reloc(CRARef& cr, ClauseAllocator& to) {
@@ -300,7 +414,12 @@ public:
         c.relocate(cr);
     }
 
+    bool extra_clause_field(void) const { return _extra_clause_field; }
     void extra_clause_field(bool use_extra) { _extra_clause_field = use_extra; }
+
+    // Give every clause allocated from now on a proof id (see Clause::id)
+    bool clause_ids(void) const { return _clause_ids; }
+    void clause_ids(bool use_id) { _clause_ids = use_id; }
 };
 
 /**
@@ -10,6 +10,9 @@
 #include <limits>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
+
+#include "config.hpp"
 
 namespace MyyuraSat {
 
@@ -21,6 +24,23 @@ private:
     uint32_t _capacity;
     uint32_t _wasted;
 
+public:
+    static const std::size_t UNIT_SIZE = sizeof(T);
+
+    using RARef = uint32_t;
+    static const RARef RAREF_UNDEF = std::numeric_limits<uint32_t>::max();
+
+    explicit RegionAllocator(uint32_t start_cap = 1024 * 1024):
+        _memory(NULL), _size(0), _capacity(0), _wasted(0) {
+        reserve(start_cap);
+    }
+
+    ~RegionAllocator(void) { if (_memory != NULL) { std::free(_memory); } }
+
+    uint32_t size(void) const { return _size; }
+    uint32_t wasted(void) const { return _wasted; }
+
+    // Make room for at least min_cap units (also usable as a size hint)
     void reserve(uint32_t min_cap) {
         if (_capacity >= min_cap) { return; }
 
@@ -46,22 +66,6 @@ private:
         if (_memory == NULL) { throw std::bad_alloc(); }
     }
 
-public:
-    static const std::size_t UNIT_SIZE = sizeof(T);
-
-    using RARef = uint32_t;
-    static const RARef RAREF_UNDEF = std::numeric_limits<uint32_t>::max();
-
-    explicit RegionAllocator(uint32_t start_cap = 1024 * 1024):
-        _memory(NULL), _size(0), _capacity(0), _wasted(0) {
-        reserve(start_cap);
-    }
-
-    ~RegionAllocator(void) { if (_memory != NULL) { std::free(_memory); } }
-
-    uint32_t size(void) const { return _size; }
-    uint32_t wasted(void) const { return _wasted; }
-
     RARef alloc(int size) {
         if (size <= 0) {
             throw std::invalid_argument("RegionAllocator<T>::alloc(int size) : the argument size must be greater than 0");
@@ -79,16 +83,24 @@ public:
     }
     void free(int size) { _wasted += size; }
 
+    // Allocate 'size' units and fill them with a copy of 'data'
+    RARef append(const T *data, int size) {
+        RARef r = alloc(size);
+        std::memcpy(&_memory[r], data, UNIT_SIZE * size);
+
+        return r;
+    }
+
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     T& operator[](RARef r) {
-        if (r >= _size) { 
+        if (CHECKS_ENABLED && r >= _size) { 
             throw std::out_of_range("RegionAllocator<T>::operator[] : index is out of range");
         }
 
         return _memory[r];
     }
     const T& operator[](RARef r) const {
-        if (r >= _size) { 
+        if (CHECKS_ENABLED && r >= _size) { 
             throw std::out_of_range("RegionAllocator<T>::operator[] : index is out of range");
         }
 
@@ -96,14 +108,14 @@ public:
     }
 
     T *lea(RARef r) {
-        if (r >= _size) { 
+        if (CHECKS_ENABLED && r >= _size) { 
             throw std::out_of_range("RegionAllocator<T>::lea() : index is out of range");
         }
 
         return &_memory[r];
     }
     const T *lea(RARef r) const {
-        if (r >= _size) { 
+        if (CHECKS_ENABLED && r >= _size) { 
             throw std::out_of_range("RegionAllocator<T>::lea() : index is out of range");
         }
 
@@ -0,0 +1,22 @@
+/**
+ * Build configuration
+ *
+ * MYYURASAT_CHECKED - Keep the bounds and state checks of the containers and
+ * the solver (the 'checked', 'debug' and 'sanitize' targets of the makefile).
+ * In release builds these checks are compiled out of the inner loops.
+ */
+
+#ifndef _MYYURASAT_CONFIG_H
+#define _MYYURASAT_CONFIG_H
+
+namespace MyyuraSat {
+
+#ifdef MYYURASAT_CHECKED
+const bool CHECKS_ENABLED = true;
+#else
+const bool CHECKS_ENABLED = false;
+#endif
+
+}
+
+#endif
@@ -6,79 +6,150 @@
 #define _MYYURASAT_UNIT_PARSER_H
 
 #include "../core/solver.hpp"
+#include "source.hpp"
 
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
 #include <new>
+#include <chrono>
 
 namespace {
 
-class UnitParser {
+/**
+ * DimacsReader -- a byte cursor over a DIMACS file.
+ *
+ * The input comes in blocks from a ByteSource (a single mapped block for
+ * regular files, see include/util/source.hpp), a token may span two blocks.
+ * There are no lines in between, so long clauses are never split.
+ */
+class DimacsReader {
 private:
-    FILE *_in;
-    char* _current_line;
-    int _pos;
-    int _size;
+    MyyuraSat::ByteSource *_source;
+    const char *_block;
+    const char *_pos;
+    const char *_end;
+    // Bytes of the blocks before '_block'
+    uint64_t _consumed;
 
-public:
-    explicit UnitParser(FILE *input, int line_size = 1024) : _in(input), _pos(0), _size(line_size) {
-        _current_line = (char*)std::realloc(NULL, _size);
-        if (_current_line == NULL) { throw std::bad_alloc(); }
+    bool refill(void) {
+        _consumed += _end - _block;
+        size_t n = _source->next(&_block);
+        _pos = _block;
+        _end = _block + n;
+
+        return n > 0;
     }
 
-    ~UnitParser(void) { std::free(_current_line); }
+    // Don't allow copying (the reader owns its source):
+    DimacsReader(const DimacsReader&);
+    DimacsReader& operator=(const DimacsReader&);
+
+public:
+    explicit DimacsReader(FILE *input) :
+        _source(MyyuraSat::open_byte_source(input)), _block(NULL), _pos(NULL), _end(NULL), _consumed(0) {}
+
+    ~DimacsReader(void) { delete _source; }
+
+    // "mmap", "stream", or the compression format
+    const char *source_name(void) const { return _source->name(); }
+
+    // Size of the input in bytes, 0 if it is unknown
+    uint64_t size_hint(void) const { return _source->size_hint(); }
+
+    // Number of (decoded) bytes scanned so far
+    uint64_t position(void) const { return _consumed + (_pos - _block); }
+
+    // Current char, EOF at the end of the input
+    int current_char(void) {
+        if (_pos == _end && !refill()) { return EOF; }
+        return (unsigned char)*_pos;
+    }
 
     void skip_whitespace(void) {
-        for (; (_current_line[_pos] >= 9 
-            && _current_line[_pos] <= 13)
-            || _current_line[_pos] == 32; _pos++) {}
+        for (int c = current_char(); (c >= 9 && c <= 13) || c == 32; c = current_char()) {
+            _pos++;
+        }
+    }
+
+    void skip_line(void) {
+        for (; ;) {
+            if (_pos == _end && !refill()) { return; }
+
+            const char *nl = (const char*)std::memchr(_pos, '\n', _end - _pos);
+            if (nl != NULL) {
+                _pos = nl + 1;
+                return;
+            }
+            _pos = _end;
+        }
+    }
+
+    bool match(const char *s) {
+        for (; *s != '\0'; s++, _pos++) {
+            if (*s != current_char()) {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     int parse_integer(void) {
-        int value = 0;
+        int64_t value = 0;
         bool neg = false;
         skip_whitespace();
 
-        if (_current_line[_pos] == '-') {
+        if (current_char() == '-') {
             neg = true;
             _pos++;
-        } else if (_current_line[_pos] == '+') {
+        } else if (current_char() == '+') {
             _pos++;
         }
 
-        if (_current_line[_pos] < '0' || _current_line[_pos] > '9') {
-            fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", _current_line[_pos]);
+        int c = current_char();
+        if (c < '0' || c > '9') {
+            fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", c);
             std::exit(3);
         }
 
-        for (; _current_line[_pos] >= '0' && _current_line[_pos] <= '9'; _pos++) {
-            value = value * 10 + (_current_line[_pos] - '0');
-        }
+        for (; ;) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if (_end - _pos >= 8) {
+                /**
+                 * Find the length of the digit run 8 bytes at a time (SWAR): a
+                 * byte is a digit iff its high nibble is 3 and its low nibble
+                 * plus 6 does not carry into the high nibble.
+                 */
+                uint64_t chunk;
+                std::memcpy(&chunk, _pos, 8);
+                uint64_t non_digits = ((chunk & 0xF0F0F0F0F0F0F0F0ULL) ^ 0x3030303030303030ULL) |
+                    (((chunk & 0x0F0F0F0F0F0F0F0FULL) + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL);
+                int n = non_digits == 0 ? 8 : (__builtin_ctzll(non_digits) >> 3);
 
-        return neg ? -value : value;
-    }
+                for (int i = 0; i < n; i++) {
+                    value = value * 10 + (_pos[i] - '0');
+                }
+                _pos += n;
 
-    bool match(const char *s) {
-        for (; *s != '\0'; s++, _pos++) {
-            if (*s != _current_line[_pos]) {
-                return false;
+                if (n < 8) { break; }
+                if (value > std::numeric_limits<int>::max()) { break; }
+                continue;
             }
-        }
+#endif
+            c = current_char();
+            if (c < '0' || c > '9' || value > std::numeric_limits<int>::max()) { break; }
 
-        return true;
-    }
-
-    bool read_line(void) {
-        if (fgets(_current_line, _size, _in) == NULL) {
-            return false;
+            value = value * 10 + (c - '0');
+            _pos++;
         }
 
-        _pos = 0;
-        return true;
-    }
+        if (value > std::numeric_limits<int>::max()) {
+            fprintf(stderr, "PARSE ERROR! Integer out of range\n");
+            std::exit(3);
+        }
 
-    char current_char(void) {
-        return _current_line[_pos];
+        return neg ? -(int)value : (int)value;
     }
 };
 
@@ -87,28 +158,41 @@ public:
 namespace MyyuraSat {
 
 void parse_dimacs(FILE* in, Solver& s) {
-    UnitParser p(in);
+    DimacsReader p(in);
     Vector<Literal> lits;
     int vars = 0;
     int clauses = 0;
     int count = 0;
 
-    for (; p.read_line();) {
+    s.begin_bulk_load();
+    for (; ;) {
         p.skip_whitespace();
-        if (p.current_char() == '\0') {
-            continue;
+        int c = p.current_char();
+        if (c == EOF) {
+            break;
         }
 
-        if (p.current_char() == 'p') {
+        if (c == 'p') {
             if (p.match("p cnf")) {
                 vars = p.parse_integer();
                 clauses = p.parse_integer();
+
+                // Pre-size the solver, the literal count is estimated from the
+                // file size (at least 'digits + sign + space' bytes per literal)
+                int digits = 1;
+                for (int v = vars; v >= 10; v /= 10) { digits++; }
+                s.reserve(clauses, p.size_hint() / (digits + 2));
+                s.proof_problem_clauses(clauses);
+
+                for (; s.n_variables() < vars;) {
+                    s.new_variable();
+                }
             } else {
                 fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", p.current_char());
                 exit(3);
             }
-        } else if (p.current_char() == 'c' || p.current_char() == 'p') {
-            continue;
+        } else if (c == 'c') {
+            p.skip_line();
         } else {
             count++;
 
@@ -123,7 +207,6 @@ void parse_dimacs(FILE* in, Solver& s) {
                 var = std::abs(parsed_lit) - 1;
 
                 for (; var >= s.n_variables();) {
-                    // std::cout << var << std::endl;
                     s.new_variable();
                 }
 
@@ -133,12 +216,49 @@ void parse_dimacs(FILE* in, Solver& s) {
             s.add_clause(lits);
         }
     }
+    s.end_bulk_load();
 
     if (count != clauses) {
         fprintf(stderr, "PARSE ERROR! DIMACS header mismatch: wrong number ofclauses\n");
     }
 }
 
+/**
+ * dimacs_benchmark : (in : FILE*) -> [void]
+ *
+ * Description:
+ *  Tokenize a whole DIMACS file without building a solver and report the
+ *  throughput of the parser in MB/s.
+ */
+void dimacs_benchmark(FILE* in) {
+    // Wall time, the decoder thread of a compressed input runs in parallel
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    DimacsReader p(in);
+    uint64_t n_literals = 0;
+    int64_t checksum = 0;
+
+    for (; ;) {
+        p.skip_whitespace();
+        int c = p.current_char();
+        if (c == EOF) {
+            break;
+        } else if (c == 'c' || c == 'p') {
+            p.skip_line();
+        } else {
+            int parsed_lit = p.parse_integer();
+            checksum += parsed_lit;
+            n_literals += parsed_lit != 0;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (seconds <= 0) { seconds = 1e-9; }
+
+    printf("dimacs benchmark (%s) | %.3f s | %llu literals | %.1f MB/s (checksum %lld)\n",
+        p.source_name(), seconds, (unsigned long long)n_literals,
+        p.position() / seconds / (1 << 20), (long long)checksum);
+}
+
 }
 
-#endif
\ No newline at end of file
+#endif
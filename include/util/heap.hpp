@@ -0,0 +1,161 @@
+/**
+ * A binary heap with support for decrease/increase key
+ */
+
+#ifndef _MYYURASAT_HEAP_H
+#define _MYYURASAT_HEAP_H
+
+#include "intmap.hpp"
+
+namespace MyyuraSat {
+
+/**
+ * Heap -- a binary heap of keys ordered by '_Comp'.
+ *
+ * Each key remembers its position in the heap array (through '_indices'), so
+ * that a key whose order changed can be moved to its new position in
+ * O(log n) time.
+ */
+template<typename K, typename _Comp, typename _Index = IntIndexDefault<K>>
+class Heap {
+private:
+    // Heap of keys
+    Vector<K> _heap;
+    // Each key's position (index) in the heap, -1 if not in the heap
+    IntMap<K, int, _Index> _indices;
+    // The heap is a minimum-heap with respect to this comparator
+    _Comp _lt;
+
+    // Index traversal functions
+    static inline int left(int i) { return i * 2 + 1; }
+    static inline int right(int i) { return (i + 1) * 2; }
+    static inline int parent(int i) { return (i - 1) >> 1; }
+
+    void percolate_up(int i) {
+        K x = _heap[i];
+        int p = parent(i);
+
+        for (; i != 0 && _lt(x, _heap[p]); p = parent(p)) {
+            _heap[i] = _heap[p];
+            _indices[_heap[p]] = i;
+            i = p;
+        }
+
+        _heap[i] = x;
+        _indices[x] = i;
+    }
+
+    void percolate_down(int i) {
+        K x = _heap[i];
+
+        for (; left(i) < _heap.size();) {
+            int child = (right(i) < _heap.size() && _lt(_heap[right(i)], _heap[left(i)])) ?
+                right(i) : left(i);
+            if (!_lt(_heap[child], x)) { break; }
+
+            _heap[i] = _heap[child];
+            _indices[_heap[i]] = i;
+            i = child;
+        }
+
+        _heap[i] = x;
+        _indices[x] = i;
+    }
+
+public:
+    explicit Heap(const _Comp& c, _Index index = _Index()) : _indices(index), _lt(c) {}
+
+    int size(void) const { return _heap.size(); }
+
+    bool empty(void) const { return _heap.size() == 0; }
+
+    bool in_heap(K k) const { return _indices.has(k) && _indices[k] >= 0; }
+
+    K operator[](int index) const { return _heap[index]; }
+
+    // The order of 'k' moved towards the top of the heap
+    void decrease(K k) {
+        if (CHECKS_ENABLED && !in_heap(k)) { throw std::logic_error("Heap<K>::decrease : key is not in the heap"); }
+
+        percolate_up(_indices[k]);
+    }
+
+    // The order of 'k' moved towards the bottom of the heap
+    void increase(K k) {
+        if (CHECKS_ENABLED && !in_heap(k)) { throw std::logic_error("Heap<K>::increase : key is not in the heap"); }
+
+        percolate_down(_indices[k]);
+    }
+
+    // Safe variant of insert/decrease/increase
+    void update(K k) {
+        if (!in_heap(k)) {
+            insert(k);
+        } else {
+            percolate_up(_indices[k]);
+            percolate_down(_indices[k]);
+        }
+    }
+
+    void insert(K k) {
+        _indices.reserve(k, -1);
+        if (CHECKS_ENABLED && in_heap(k)) { throw std::logic_error("Heap<K>::insert : key is already in the heap"); }
+
+        _indices[k] = _heap.size();
+        _heap.push(k);
+        percolate_up(_indices[k]);
+    }
+
+    void remove(K k) {
+        if (CHECKS_ENABLED && !in_heap(k)) { throw std::logic_error("Heap<K>::remove : key is not in the heap"); }
+
+        int k_pos = _indices[k];
+        _indices[k] = -1;
+
+        if (k_pos < _heap.size() - 1) {
+            _heap[k_pos] = _heap.back();
+            _indices[_heap[k_pos]] = k_pos;
+            _heap.pop();
+            percolate_down(k_pos);
+            percolate_up(_indices[_heap[k_pos]]);
+        } else {
+            _heap.pop();
+        }
+    }
+
+    K remove_min(void) {
+        if (CHECKS_ENABLED && empty()) { throw std::logic_error("Heap<K>::remove_min : heap is empty"); }
+
+        K x = _heap[0];
+        _heap[0] = _heap.back();
+        _indices[_heap[0]] = 0;
+        _indices[x] = -1;
+        _heap.pop();
+        if (_heap.size() > 1) { percolate_down(0); }
+
+        return x;
+    }
+
+    // Rebuild the heap from scratch, using the elements in 'ns':
+    void build(const Vector<K>& ns) {
+        for (int i = 0; i < _heap.size(); i++) { _indices[_heap[i]] = -1; }
+        _heap.clear();
+
+        for (int i = 0; i < ns.size(); i++) {
+            _indices.reserve(ns[i], -1);
+            _indices[ns[i]] = i;
+            _heap.push(ns[i]);
+        }
+
+        for (int i = _heap.size() / 2 - 1; i >= 0; i--) { percolate_down(i); }
+    }
+
+    void clear(bool dispose = false) {
+        for (int i = 0; i < _heap.size(); i++) { _indices[_heap[i]] = -1; }
+        _heap.clear(dispose);
+    }
+};
+
+}
+
+#endif
@@ -6,6 +6,7 @@
 #define _MYYURASAT_INTMAP_H
 
 #include "vector.hpp"
+#include "config.hpp"
 
 namespace MyyuraSat {
 
@@ -23,13 +24,13 @@ public:
     bool has(K k) const { return _index(k) < _map.size(); }
 
     const V& operator[](K k) const {
-        if (!has(k)) { throw std::out_of_range("IntMap<K, V>::operator[] : out of range"); }
+        if (CHECKS_ENABLED && !has(k)) { throw std::out_of_range("IntMap<K, V>::operator[] : out of range"); }
 
         return _map[_index(k)];
     }
 
     V& operator[](K k) {
-        if (!has(k)) { throw std::out_of_range("IntMap<K, V>::operator[] : out of range"); }
+        if (CHECKS_ENABLED && !has(k)) { throw std::out_of_range("IntMap<K, V>::operator[] : out of range"); }
 
         return _map[_index(k)];
     }
@@ -0,0 +1,242 @@
+/**
+ * Proof output
+ *
+ * Clausal proofs of unsatisfiability in DRAT (text or binary) and LRAT (text
+ * or binary). The bytes of the proof are written by a separate thread, see
+ * ProofWriter.
+ */
+
+#ifndef _MYYURASAT_PROOF_H
+#define _MYYURASAT_PROOF_H
+
+#include "../type/literal.hpp"
+#include "vector.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace MyyuraSat {
+
+enum ProofFormat {
+    PROOF_DRAT,
+    PROOF_DRAT_BINARY,
+    PROOF_LRAT,
+    PROOF_LRAT_BINARY
+};
+
+/**
+ * ProofWriter -- a byte sink drained by a writer thread.
+ *
+ * The solver appends to one of two buffers without any synchronization. A full
+ * buffer is handed over to the writer thread by publishing its size (an atomic
+ * store), and the solver continues in the other buffer. Only if the writer
+ * thread is still busy with that other buffer does the solver have to wait,
+ * and the writer thread sleeps while there is nothing to write.
+ */
+class ProofWriter {
+private:
+    static const size_t BUFFER_SIZE = 1 << 22;
+
+    FILE *_out;
+    char *_buffers[2];
+    // Bytes of a buffer handed over to the writer thread, 0 if it is free
+    std::atomic<size_t> _sizes[2];
+    std::atomic<bool> _closing;
+
+    // Buffer the solver is appending to
+    int _current;
+    size_t _pos;
+
+    // Only used to sleep, the buffers are handed over through '_sizes'
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread _thread;
+
+    void notify(void) {
+        { std::lock_guard<std::mutex> lock(_mutex); }
+        _cond.notify_all();
+    }
+
+    void run(void) {
+        for (int i = 0; ; i ^= 1) {
+            if (_sizes[i].load(std::memory_order_acquire) == 0) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cond.wait(lock, [&] { return _sizes[i].load(std::memory_order_acquire) != 0 || _closing.load(); });
+
+                if (_sizes[i].load(std::memory_order_acquire) == 0) { return; }
+            }
+
+            fwrite(_buffers[i], 1, _sizes[i].load(std::memory_order_relaxed), _out);
+            _sizes[i].store(0, std::memory_order_release);
+            notify();
+        }
+    }
+
+    // Hand the current buffer over to the writer thread
+    void swap(void) {
+        if (_pos == 0) { return; }
+
+        _sizes[_current].store(_pos, std::memory_order_release);
+        notify();
+
+        _current ^= 1;
+        _pos = 0;
+        if (_sizes[_current].load(std::memory_order_acquire) != 0) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [&] { return _sizes[_current].load(std::memory_order_acquire) == 0; });
+        }
+    }
+
+    // Don't allow copying (the writer owns its buffers and thread):
+    ProofWriter(const ProofWriter&);
+    ProofWriter& operator=(const ProofWriter&);
+
+public:
+    explicit ProofWriter(FILE *out) : _out(out), _closing(false), _current(0), _pos(0) {
+        for (int i = 0; i < 2; i++) {
+            _buffers[i] = (char*)std::malloc(BUFFER_SIZE);
+            if (_buffers[i] == NULL) { throw std::bad_alloc(); }
+            _sizes[i].store(0);
+        }
+
+        _thread = std::thread(&ProofWriter::run, this);
+    }
+
+    ~ProofWriter(void) {
+        swap();
+        _closing.store(true);
+        notify();
+        _thread.join();
+        fflush(_out);
+
+        for (int i = 0; i < 2; i++) { std::free(_buffers[i]); }
+    }
+
+    void put(char c) {
+        if (_pos == BUFFER_SIZE) { swap(); }
+        _buffers[_current][_pos++] = c;
+    }
+
+    // Short writes (a number or a keyword) are copied in one piece
+    void write(const char *s, size_t n) {
+        if (BUFFER_SIZE - _pos < n) { swap(); }
+        std::memcpy(_buffers[_current] + _pos, s, n);
+        _pos += n;
+    }
+
+    // Unsigned LEB128, as used by the binary DRAT/LRAT formats
+    void put_varint(uint64_t x) {
+        char bytes[10];
+        int n = 0;
+        for (; x > 127; x >>= 7) { bytes[n++] = (char)((x & 127) | 128); }
+        bytes[n++] = (char)x;
+        write(bytes, n);
+    }
+
+    // Decimal followed by a space, as used by the text formats
+    void put_int(int64_t x) {
+        char digits[22];
+        int n = sizeof(digits);
+        uint64_t u = x < 0 ? -(uint64_t)x : (uint64_t)x;
+
+        digits[--n] = ' ';
+        do {
+            digits[--n] = '0' + u % 10;
+            u /= 10;
+        } while (u > 0);
+        if (x < 0) { digits[--n] = '-'; }
+
+        write(digits + n, sizeof(digits) - n);
+    }
+};
+
+/**
+ * Proof -- write proof steps in one of the 'ProofFormat's.
+ *
+ * Clause ids and hints are only used by LRAT, 'add' is given the ids of the
+ * clauses that make the added clause RUP, in the order a checker has to
+ * propagate them.
+ */
+class Proof {
+private:
+    ProofWriter _writer;
+    ProofFormat _format;
+    // The last id added (LRAT deletions are tagged with it)
+    uint64_t _last_id;
+
+    void put_literal(Literal p) {
+        if (_format == PROOF_DRAT_BINARY || _format == PROOF_LRAT_BINARY) {
+            _writer.put_varint(2 * (uint64_t)(p.variable() + 1) + p.sign());
+        } else {
+            _writer.put_int(p.sign() ? -(int64_t)(p.variable() + 1) : (int64_t)(p.variable() + 1));
+        }
+    }
+
+    void put_id(uint64_t id) {
+        if (_format == PROOF_LRAT_BINARY) {
+            _writer.put_varint(2 * id);
+        } else {
+            _writer.put_int((int64_t)id);
+        }
+    }
+
+    void put_end(bool line) {
+        if (binary()) {
+            _writer.put(0);
+        } else {
+            _writer.put('0');
+            _writer.put(line ? '\n' : ' ');
+        }
+    }
+
+public:
+    Proof(FILE *out, ProofFormat format) : _writer(out), _format(format), _last_id(0) {}
+
+    bool lrat(void) const { return _format == PROOF_LRAT || _format == PROOF_LRAT_BINARY; }
+
+    bool binary(void) const { return _format == PROOF_DRAT_BINARY || _format == PROOF_LRAT_BINARY; }
+
+    void add(const Literal *lits, int n, uint64_t id, const Vector<uint64_t>& hints) {
+        if (binary()) { _writer.put('a'); }
+
+        if (lrat()) {
+            put_id(id);
+            _last_id = id;
+        }
+
+        for (int i = 0; i < n; i++) { put_literal(lits[i]); }
+
+        if (lrat()) {
+            put_end(false);
+            for (int i = 0; i < hints.size(); i++) { put_id(hints[i]); }
+        }
+        put_end(true);
+    }
+
+    void remove(const Literal *lits, int n, uint64_t id) {
+        if (lrat()) {
+            if (binary()) {
+                _writer.put('d');
+            } else {
+                put_id(_last_id);
+                _writer.write("d ", 2);
+            }
+            put_id(id);
+        } else {
+            _writer.write(binary() ? "d" : "d ", binary() ? 1 : 2);
+            for (int i = 0; i < n; i++) { put_literal(lits[i]); }
+        }
+        put_end(true);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * Byte sources for the input parser
+ *
+ * A ByteSource hands out the input as a sequence of blocks. Regular files are
+ * memory mapped (one block, no copying), other streams are read in chunks,
+ * and compressed inputs (detected by their magic bytes) are decoded on a
+ * separate thread into two alternating buffers, so that decoding and parsing
+ * overlap.
+ *
+ * MYYURASAT_ZSTD - Build with zstd support (needs zstd.h and -lzstd).
+ */
+
+#ifndef _MYYURASAT_SOURCE_H
+#define _MYYURASAT_SOURCE_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+#include <lzma.h>
+#include <bzlib.h>
+#ifdef MYYURASAT_ZSTD
+#include <zstd.h>
+#endif
+
+namespace MyyuraSat {
+
+/**
+ * ByteSource -- the input as a sequence of blocks.
+ *
+ * A block returned by 'next' stays valid until the following call to 'next'.
+ * 'unread' pushes the last block back, so that the first bytes of an input can
+ * be inspected (see 'open_byte_source').
+ */
+class ByteSource {
+private:
+    const char *_last;
+    size_t _last_size;
+    bool _unread;
+
+    // Don't allow copying (sources own their buffers):
+    ByteSource(const ByteSource&);
+    ByteSource& operator=(const ByteSource&);
+
+protected:
+    // Next block of the input, 0 at the end of the input
+    virtual size_t read(const char **data) = 0;
+
+public:
+    ByteSource(void) : _last(NULL), _last_size(0), _unread(false) {}
+
+    virtual ~ByteSource(void) {}
+
+    size_t next(const char **data) {
+        if (!_unread) {
+            _last_size = read(&_last);
+        }
+
+        _unread = false;
+        *data = _last;
+        return _last_size;
+    }
+
+    void unread(void) { _unread = true; }
+
+    // Size of the decoded input in bytes, 0 if it is unknown
+    virtual uint64_t size_hint(void) const { return 0; }
+
+    virtual const char *name(void) const = 0;
+};
+
+/**
+ * MappedSource -- a memory mapped regular file, handed out as a single block.
+ */
+class MappedSource : public ByteSource {
+private:
+    void *_map;
+    size_t _size;
+    bool _done;
+
+protected:
+    size_t read(const char **data) {
+        *data = (const char*)_map;
+        if (_done) { return 0; }
+
+        _done = true;
+        return _size;
+    }
+
+public:
+    MappedSource(void *map, size_t size) : _map(map), _size(size), _done(false) {
+        madvise(_map, _size, MADV_SEQUENTIAL);
+    }
+
+    ~MappedSource(void) { munmap(_map, _size); }
+
+    uint64_t size_hint(void) const { return _size; }
+
+    const char *name(void) const { return "mmap"; }
+};
+
+/**
+ * StreamSource -- pipes and other streams that can't be mapped, read in
+ * chunks of 'CHUNK_SIZE' bytes.
+ */
+class StreamSource : public ByteSource {
+private:
+    static const size_t CHUNK_SIZE = 1 << 20;
+
+    FILE *_in;
+    char *_buffer;
+
+protected:
+    size_t read(const char **data) {
+        *data = _buffer;
+        return fread(_buffer, 1, CHUNK_SIZE, _in);
+    }
+
+public:
+    explicit StreamSource(FILE *input) : _in(input) {
+        _buffer = (char*)std::malloc(CHUNK_SIZE);
+        if (_buffer == NULL) { throw std::bad_alloc(); }
+    }
+
+    ~StreamSource(void) { std::free(_buffer); }
+
+    const char *name(void) const { return "stream"; }
+};
+
+/**
+ * Decoder -- decompress the blocks of an underlying (raw) source.
+ *
+ * 'decode' fills 'out' with up to 'cap' decoded bytes and returns how many were
+ * written, 0 at the end of the input. On corrupt input it sets '_error'.
+ */
+class Decoder {
+protected:
+    ByteSource *_in;
+    const char *_error;
+
+    // Compressed bytes not yet consumed
+    const char *_in_pos;
+    size_t _in_size;
+    bool _in_eof;
+
+    // Make sure there are compressed bytes available (false at the end)
+    bool fetch_input(void) {
+        if (_in_size == 0 && !_in_eof) {
+            _in_size = _in->next(&_in_pos);
+            _in_eof = _in_size == 0;
+        }
+
+        return _in_size > 0;
+    }
+
+    void consume_input(size_t n) {
+        _in_pos += n;
+        _in_size -= n;
+    }
+
+public:
+    explicit Decoder(ByteSource *input) :
+        _in(input), _error(NULL), _in_pos(NULL), _in_size(0), _in_eof(false) {}
+
+    virtual ~Decoder(void) { delete _in; }
+
+    virtual size_t decode(char *out, size_t cap) = 0;
+
+    const char *error(void) const { return _error; }
+
+    virtual const char *name(void) const = 0;
+};
+
+class GzipDecoder : public Decoder {
+private:
+    z_stream _strm;
+    bool _end;
+
+public:
+    explicit GzipDecoder(ByteSource *input) : Decoder(input), _end(false) {
+        std::memset(&_strm, 0, sizeof(_strm));
+        // 15 + 32: maximum window, accept both gzip and zlib headers
+        if (inflateInit2(&_strm, 15 + 32) != Z_OK) { throw std::bad_alloc(); }
+    }
+
+    ~GzipDecoder(void) { inflateEnd(&_strm); }
+
+    size_t decode(char *out, size_t cap) {
+        _strm.next_out = (Bytef*)out;
+        _strm.avail_out = (uInt)cap;
+
+        for (; _strm.avail_out > 0 && !_end && _error == NULL;) {
+            if (!fetch_input()) {
+                _error = "gzip: unexpected end of input";
+                break;
+            }
+
+            _strm.next_in = (Bytef*)_in_pos;
+            _strm.avail_in = (uInt)_in_size;
+            int ret = inflate(&_strm, Z_NO_FLUSH);
+            consume_input(_in_size - _strm.avail_in);
+
+            if (ret == Z_STREAM_END) {
+                // Concatenated members ('cat a.gz b.gz') are decoded as one file
+                if (fetch_input()) {
+                    inflateReset(&_strm);
+                } else {
+                    _end = true;
+                }
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                _error = "gzip: corrupt input";
+            }
+        }
+
+        return cap - _strm.avail_out;
+    }
+
+    const char *name(void) const { return "gzip"; }
+};
+
+class XzDecoder : public Decoder {
+private:
+    lzma_stream _strm;
+    bool _end;
+
+public:
+    explicit XzDecoder(ByteSource *input) : Decoder(input), _end(false) {
+        lzma_stream init = LZMA_STREAM_INIT;
+        _strm = init;
+        if (lzma_stream_decoder(&_strm, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~XzDecoder(void) { lzma_end(&_strm); }
+
+    size_t decode(char *out, size_t cap) {
+        _strm.next_out = (uint8_t*)out;
+        _strm.avail_out = cap;
+
+        for (; _strm.avail_out > 0 && !_end && _error == NULL;) {
+            // LZMA_CONCATENATED needs LZMA_FINISH to see the end of the input
+            lzma_action action = fetch_input() ? LZMA_RUN : LZMA_FINISH;
+
+            _strm.next_in = (const uint8_t*)_in_pos;
+            _strm.avail_in = _in_size;
+            lzma_ret ret = lzma_code(&_strm, action);
+            consume_input(_in_size - _strm.avail_in);
+
+            if (ret == LZMA_STREAM_END) {
+                _end = true;
+            } else if (ret != LZMA_OK) {
+                _error = "xz: corrupt input";
+            }
+        }
+
+        return cap - _strm.avail_out;
+    }
+
+    const char *name(void) const { return "xz"; }
+};
+
+class Bzip2Decoder : public Decoder {
+private:
+    bz_stream _strm;
+    bool _end;
+
+public:
+    explicit Bzip2Decoder(ByteSource *input) : Decoder(input), _end(false) {
+        std::memset(&_strm, 0, sizeof(_strm));
+        if (BZ2_bzDecompressInit(&_strm, 0, 0) != BZ_OK) { throw std::bad_alloc(); }
+    }
+
+    ~Bzip2Decoder(void) { BZ2_bzDecompressEnd(&_strm); }
+
+    size_t decode(char *out, size_t cap) {
+        _strm.next_out = out;
+        _strm.avail_out = (unsigned)cap;
+
+        for (; _strm.avail_out > 0 && !_end && _error == NULL;) {
+            if (!fetch_input()) {
+                _error = "bzip2: unexpected end of input";
+                break;
+            }
+
+            _strm.next_in = (char*)_in_pos;
+            _strm.avail_in = (unsigned)_in_size;
+            int ret = BZ2_bzDecompress(&_strm);
+            consume_input(_in_size - _strm.avail_in);
+
+            if (ret == BZ_STREAM_END) {
+                // Concatenated streams (as written by pbzip2)
+                if (fetch_input()) {
+                    BZ2_bzDecompressEnd(&_strm);
+                    BZ2_bzDecompressInit(&_strm, 0, 0);
+                } else {
+                    _end = true;
+                }
+            } else if (ret != BZ_OK) {
+                _error = "bzip2: corrupt input";
+            }
+        }
+
+        return cap - _strm.avail_out;
+    }
+
+    const char *name(void) const { return "bzip2"; }
+};
+
+#ifdef MYYURASAT_ZSTD
+class ZstdDecoder : public Decoder {
+private:
+    ZSTD_DStream *_strm;
+
+public:
+    explicit ZstdDecoder(ByteSource *input) : Decoder(input), _strm(ZSTD_createDStream()) {
+        if (_strm == NULL) { throw std::bad_alloc(); }
+        ZSTD_initDStream(_strm);
+    }
+
+    ~ZstdDecoder(void) { ZSTD_freeDStream(_strm); }
+
+    size_t decode(char *out, size_t cap) {
+        ZSTD_outBuffer output = { out, cap, 0 };
+
+        for (; output.pos < cap && _error == NULL && fetch_input();) {
+            ZSTD_inBuffer input = { _in_pos, _in_size, 0 };
+            size_t ret = ZSTD_decompressStream(_strm, &output, &input);
+            consume_input(input.pos);
+
+            if (ZSTD_isError(ret)) {
+                _error = "zstd: corrupt input";
+            }
+        }
+
+        return output.pos;
+    }
+
+    const char *name(void) const { return "zstd"; }
+};
+#endif
+
+/**
+ * DecodedSource -- run a Decoder on its own thread.
+ *
+ * The decoder thread fills one of two buffers while the parser reads the
+ * other one. A buffer handed out by 'read' is given back to the decoder
+ * thread on the following call to 'read'.
+ */
+class DecodedSource : public ByteSource {
+private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    struct _Buffer {
+        char *data;
+        size_t size;
+        bool full;
+    };
+
+    Decoder *_decoder;
+    _Buffer _buffers[2];
+    // Buffer the parser reads next, -1 before the first read
+    int _current;
+    bool _stop;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread _thread;
+
+    void run(void) {
+        for (int i = 0; ; i ^= 1) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cond.wait(lock, [&] { return _stop || !_buffers[i].full; });
+                if (_stop) { return; }
+            }
+
+            // The buffer is empty, so the parser doesn't touch it
+            size_t n = _decoder->decode(_buffers[i].data, BUFFER_SIZE);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _buffers[i].size = n;
+                _buffers[i].full = true;
+            }
+            _cond.notify_all();
+
+            // An empty buffer marks the end of the input (or an error)
+            if (n == 0) { return; }
+        }
+    }
+
+protected:
+    size_t read(const char **data) {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (_current >= 0) {
+            // Done with the previous buffer, unless it was the last one
+            if (_buffers[_current].size == 0) {
+                *data = _buffers[_current].data;
+                return 0;
+            }
+
+            _buffers[_current].full = false;
+            _current ^= 1;
+            _cond.notify_all();
+        } else {
+            _current = 0;
+        }
+
+        _cond.wait(lock, [&] { return _buffers[_current].full; });
+
+        if (_buffers[_current].size == 0 && _decoder->error() != NULL) {
+            fprintf(stderr, "PARSE ERROR! %s\n", _decoder->error());
+            std::exit(3);
+        }
+
+        *data = _buffers[_current].data;
+        return _buffers[_current].size;
+    }
+
+public:
+    explicit DecodedSource(Decoder *decoder) : _decoder(decoder), _current(-1), _stop(false) {
+        for (int i = 0; i < 2; i++) {
+            _buffers[i].data = (char*)std::malloc(BUFFER_SIZE);
+            if (_buffers[i].data == NULL) { throw std::bad_alloc(); }
+            _buffers[i].size = 0;
+            _buffers[i].full = false;
+        }
+
+        _thread = std::thread(&DecodedSource::run, this);
+    }
+
+    ~DecodedSource(void) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_all();
+        _thread.join();
+
+        delete _decoder;
+        for (int i = 0; i < 2; i++) { std::free(_buffers[i].data); }
+    }
+
+    const char *name(void) const { return _decoder->name(); }
+};
+
+/**
+ * open_byte_source : (in : FILE*) -> [ByteSource*]
+ *
+ * Description:
+ *  Map 'in' if it is a regular file, otherwise read it as a stream. If the
+ *  first bytes are the magic number of gzip, xz, bzip2 or zstd, the input is
+ *  decoded on the fly. The caller owns the returned source.
+ */
+ByteSource *open_byte_source(FILE *in) {
+    ByteSource *raw = NULL;
+    struct stat st;
+    int fd = fileno(in);
+
+    if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && ftell(in) == 0) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            raw = new MappedSource(map, st.st_size);
+        }
+    }
+    if (raw == NULL) {
+        raw = new StreamSource(in);
+    }
+
+    const char *head;
+    size_t n = raw->next(&head);
+    raw->unread();
+
+    const unsigned char *magic = (const unsigned char*)head;
+    if (n >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+        return new DecodedSource(new GzipDecoder(raw));
+    } else if (n >= 6 && std::memcmp(magic, "\xFD" "7zXZ\0", 6) == 0) {
+        return new DecodedSource(new XzDecoder(raw));
+    } else if (n >= 3 && std::memcmp(magic, "BZh", 3) == 0) {
+        return new DecodedSource(new Bzip2Decoder(raw));
+    } else if (n >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+#ifdef MYYURASAT_ZSTD
+        return new DecodedSource(new ZstdDecoder(raw));
+#else
+        fprintf(stderr, "PARSE ERROR! zstd input, but built without MYYURASAT_ZSTD\n");
+        std::exit(3);
+#endif
+    }
+
+    return raw;
+}
+
+}
+
+#endif
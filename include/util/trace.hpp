@@ -0,0 +1,124 @@
+/**
+ * Tracing
+ *
+ * Trace messages are only compiled in when MYYURASAT_TRACE is defined (the
+ * 'debug' target of the makefile). Otherwise 'Tracer' is an empty class and
+ * every call to it is an empty inline function, so the hot paths pay nothing.
+ */
+
+#ifndef _MYYURASAT_TRACE_H
+#define _MYYURASAT_TRACE_H
+
+#include <cstdio>
+#include <cstdint>
+
+namespace MyyuraSat {
+
+enum TraceCategory {
+    TRACE_PROPAGATE = 1,
+    TRACE_ANALYZE   = 2,
+    TRACE_DECIDE    = 4,
+    TRACE_GC        = 8,
+    TRACE_ALL       = 15
+};
+
+#ifdef MYYURASAT_TRACE
+const bool TRACE_ENABLED = true;
+#else
+const bool TRACE_ENABLED = false;
+#endif
+
+template<bool _Enabled>
+class TraceRing;
+
+/**
+ * TraceRing<false> -- tracing compiled out.
+ */
+template<>
+class TraceRing<false> {
+public:
+    void level(int) {}
+    void categories(unsigned) {}
+    bool enabled(TraceCategory, int) const { return false; }
+
+    template<typename... Args>
+    void log(TraceCategory, int, const char *, Args...) {}
+
+    void dump(FILE *) const {}
+    void clear(void) {}
+};
+
+/**
+ * TraceRing<true> -- keep the last 'CAPACITY' messages in a ring buffer.
+ * Nothing is written out until 'dump' is called.
+ */
+template<>
+class TraceRing<true> {
+public:
+    static const int CAPACITY = 4096;
+    static const int LINE_SIZE = 120;
+
+private:
+    struct _Entry {
+        TraceCategory category;
+        char line[LINE_SIZE];
+    };
+
+    _Entry *_entries;
+    uint64_t _count;
+    int _level;
+    unsigned _categories;
+
+    static const char *category_name(TraceCategory c) {
+        switch (c) {
+            case TRACE_PROPAGATE: return "propagate";
+            case TRACE_ANALYZE: return "analyze";
+            case TRACE_DECIDE: return "decide";
+            case TRACE_GC: return "gc";
+            default: return "?";
+        }
+    }
+
+    // Don't allow copying (the ring owns its buffer):
+    TraceRing(const TraceRing&);
+    TraceRing& operator=(const TraceRing&);
+
+public:
+    TraceRing(void) : _entries(new _Entry[CAPACITY]), _count(0), _level(2), _categories(TRACE_ALL) {}
+
+    ~TraceRing(void) { delete[] _entries; }
+
+    // Messages above this level of detail are ignored
+    void level(int l) { _level = l; }
+
+    // A mask of TraceCategory
+    void categories(unsigned mask) { _categories = mask; }
+
+    bool enabled(TraceCategory c, int l) const { return (_categories & c) && l <= _level; }
+
+    template<typename... Args>
+    void log(TraceCategory c, int l, const char *format, Args... args) {
+        if (!enabled(c, l)) { return; }
+
+        _Entry& e = _entries[_count++ % CAPACITY];
+        e.category = c;
+        std::snprintf(e.line, LINE_SIZE, format, args...);
+    }
+
+    // Write the buffered messages, oldest first
+    void dump(FILE *out) const {
+        uint64_t first = _count > (uint64_t)CAPACITY ? _count - CAPACITY : 0;
+        for (uint64_t i = first; i < _count; i++) {
+            const _Entry& e = _entries[i % CAPACITY];
+            std::fprintf(out, "[%llu %s] %s\n", (unsigned long long)i, category_name(e.category), e.line);
+        }
+    }
+
+    void clear(void) { _count = 0; }
+};
+
+using Tracer = TraceRing<TRACE_ENABLED>;
+
+}
+
+#endif
@@ -15,6 +15,8 @@
 #include <initializer_list>
 #include <algorithm>
 
+#include "config.hpp"
+
 namespace MyyuraSat {
 
 template<typename T, typename _Size = int>
@@ -118,7 +120,7 @@ public:
     }
 
     void push_lazy(const T& elem) {
-        if (_size >= _capacity) {
+        if (CHECKS_ENABLED && _size >= _capacity) {
             throw std::out_of_range("Vector<T>::push_lazy : out of size");
         }
 
@@ -132,7 +134,7 @@ public:
     }
 
     void pop(void) {
-        if (_size <= 0) { throw std::logic_error("Vector<T>::pop : no elements left"); }
+        if (CHECKS_ENABLED && _size <= 0) { throw std::logic_error("Vector<T>::pop : no elements left"); }
 
         _data[--_size].~T();
     }
@@ -4,28 +4,302 @@
 #include "./solver_basic.cpp"
 #include "./solver_search.cpp"
 #include "./solver_simplify.cpp"
+#include "./solver_gauss.cpp"
+#include "./solver_cache.cpp"
+#include "./solver_proof.cpp"
 
 #include "./solver_debug.cpp"
 
 #include <ctime>
+#include <cstring>
 #include <iostream>
 
+#include <csignal>
+
+#include <unistd.h>
+
+static MyyuraSat::Solver * volatile solver = NULL;
+
+// The first SIGINT/SIGTERM stops the search (the result is UNKNOWN), a second
+// one exits right away
+static void interrupt_handler(int) {
+    if (solver != NULL) {
+        solver->interrupt();
+        solver = NULL;
+    } else {
+        _exit(1);
+    }
+}
+
+/**
+ * print_result : (s : Solver&) (status : LiftedBoolean) -> [void]
+ *
+ * Description:
+ *  Print the result in the SAT competition format: an 's' line, and for a 
+ *  satisfiable problem the model in 'v' lines.
+ */
+static void print_result(const MyyuraSat::Solver& s, MyyuraSat::LiftedBoolean status) {
+    if (status == MyyuraSat::LIFTED_BOOLEAN_TRUE) {
+        printf("s SATISFIABLE\n");
+        for (int i = 0; i < s.n_variables(); i++) {
+            if (i % 10 == 0) { printf("v"); }
+            printf(s.model_value(i) == MyyuraSat::LIFTED_BOOLEAN_TRUE ? " %d" : " -%d", i + 1);
+            if (i % 10 == 9) { printf("\n"); }
+        }
+        if (s.n_variables() % 10 != 0) { printf("\n"); }
+        printf("v 0\n");
+    } else if (status == MyyuraSat::LIFTED_BOOLEAN_FALSE) {
+        printf("s UNSATISFIABLE\n");
+    } else {
+        printf("s UNKNOWN\n");
+    }
+}
+
+/**
+ * load_problem : (input : const char*, cache : const char*, s : Solver&) -> [void]
+ *
+ * Description:
+ *  Parse 'input' into 's'. With a cache path, the problem is loaded from the
+ *  cache if it was built from the same, unchanged input file, otherwise the
+ *  input is parsed and the cache is written.
+ */
+static void load_problem(const char *input, const char *cache, MyyuraSat::Solver& s) {
+    if (cache != NULL && s.load_cache(cache, input)) {
+        return;
+    }
+
+    FILE *fp = fopen(input, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "ERROR! Could not open file: %s\n", input);
+        exit(1);
+    }
+    parse_dimacs(fp, s);
+    fclose(fp);
+
+    if (cache != NULL && !s.save_cache(cache, input)) {
+        fprintf(stderr, "WARNING! Could not write cache: %s\n", cache);
+    }
+}
+
+/**
+ * open_input : (input : const char*) -> [FILE*]
+ *
+ * Description:
+ *  Open 'input' for reading, exit with an error if there is none or it can't
+ *  be opened.
+ */
+static FILE *open_input(const char *input) {
+    FILE *fp = input == NULL ? NULL : fopen(input, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "ERROR! Could not open file: %s\n", input == NULL ? "(no input)" : input);
+        exit(1);
+    }
+    return fp;
+}
+
 int main(int argc, char **argv) {
-    FILE *fp = fopen(argv[1], "r");
+    MyyuraSat::BranchHeuristic branch = MyyuraSat::BRANCH_VSIDS;
+    MyyuraSat::RestartPolicy restart = MyyuraSat::RESTART_GLUCOSE;
+    bool bench_branch = false;
+    bool bench_propagate = false;
+    bool bench_parse = false;
+    bool bench_xor = false;
+    int trace_level = -1;
+    const char *input = NULL;
+    const char *cache = NULL;
+    const char *proof = NULL;
+    int64_t conflicts = -1;
+    int64_t propagations = -1;
+    double seconds = -1;
+    uint64_t megabytes = 0;
+    int64_t subsumption_effort = -1;
+    bool elimination = true;
+    bool blocked_elimination = true;
+    bool covered_elimination = true;
+    bool probing = true;
+    bool vivification = true;
+    bool gauss = true;
+    MyyuraSat::ProofFormat proof_format = MyyuraSat::PROOF_DRAT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-branch=vsids") == 0) {
+            branch = MyyuraSat::BRANCH_VSIDS;
+        } else if (strcmp(argv[i], "-branch=vmtf") == 0) {
+            branch = MyyuraSat::BRANCH_VMTF;
+        } else if (strcmp(argv[i], "-branch=occurence") == 0) {
+            branch = MyyuraSat::BRANCH_OCCURENCE;
+        } else if (strcmp(argv[i], "-restart=luby") == 0) {
+            restart = MyyuraSat::RESTART_LUBY;
+        } else if (strcmp(argv[i], "-restart=geometric") == 0) {
+            restart = MyyuraSat::RESTART_GEOMETRIC;
+        } else if (strcmp(argv[i], "-restart=glucose") == 0) {
+            restart = MyyuraSat::RESTART_GLUCOSE;
+        } else if (strncmp(argv[i], "-trace=", 7) == 0) {
+            trace_level = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "-cache=", 7) == 0) {
+            cache = argv[i] + 7;
+        } else if (strncmp(argv[i], "-conflicts=", 11) == 0) {
+            conflicts = atoll(argv[i] + 11);
+        } else if (strncmp(argv[i], "-propagations=", 14) == 0) {
+            propagations = atoll(argv[i] + 14);
+        } else if (strncmp(argv[i], "-time=", 6) == 0) {
+            seconds = atof(argv[i] + 6);
+        } else if (strncmp(argv[i], "-mem=", 5) == 0) {
+            megabytes = strtoull(argv[i] + 5, NULL, 10);
+        } else if (strcmp(argv[i], "-no-elim") == 0) {
+            elimination = false;
+        } else if (strcmp(argv[i], "-no-bce") == 0) {
+            blocked_elimination = false;
+        } else if (strcmp(argv[i], "-no-cce") == 0) {
+            covered_elimination = false;
+        } else if (strcmp(argv[i], "-no-probe") == 0) {
+            probing = false;
+        } else if (strcmp(argv[i], "-no-vivify") == 0) {
+            vivification = false;
+        } else if (strcmp(argv[i], "-no-gauss") == 0) {
+            gauss = false;
+        } else if (strncmp(argv[i], "-subsumption-effort=", 20) == 0) {
+            subsumption_effort = atoll(argv[i] + 20);
+        } else if (strncmp(argv[i], "-proof=", 7) == 0) {
+            proof = argv[i] + 7;
+        } else if (strcmp(argv[i], "-proof-format=drat") == 0) {
+            proof_format = MyyuraSat::PROOF_DRAT;
+        } else if (strcmp(argv[i], "-proof-format=drat-binary") == 0) {
+            proof_format = MyyuraSat::PROOF_DRAT_BINARY;
+        } else if (strcmp(argv[i], "-proof-format=lrat") == 0) {
+            proof_format = MyyuraSat::PROOF_LRAT;
+        } else if (strcmp(argv[i], "-proof-format=lrat-binary") == 0) {
+            proof_format = MyyuraSat::PROOF_LRAT_BINARY;
+        } else if (strcmp(argv[i], "-bench-branch") == 0) {
+            bench_branch = true;
+        } else if (strcmp(argv[i], "-bench-propagate") == 0) {
+            bench_propagate = true;
+        } else if (strcmp(argv[i], "-bench-parse") == 0) {
+            bench_parse = true;
+        } else if (strcmp(argv[i], "-bench-xor") == 0) {
+            bench_xor = true;
+        } else {
+            input = argv[i];
+        }
+    }
+
+    if (bench_branch) {
+        // Same input for every heuristic, parsed into a fresh solver each time
+        const MyyuraSat::BranchHeuristic heuristics[] = { MyyuraSat::BRANCH_VSIDS, MyyuraSat::BRANCH_VMTF };
+        for (MyyuraSat::BranchHeuristic h : heuristics) {
+            FILE *fp = open_input(input);
+            MyyuraSat::Solver s;
+            s.restart_policy(restart);
+            parse_dimacs(fp, s);
+            fclose(fp);
+            s.branch_benchmark(h);
+        }
+        return 0;
+    }
+
+    if (bench_parse) {
+        // Tokenizer alone, then a full parse into a solver
+        FILE *fp = open_input(input);
+        MyyuraSat::dimacs_benchmark(fp);
+        fclose(fp);
+
+        fp = open_input(input);
+        MyyuraSat::Solver s;
+        int start_time = clock();
+        parse_dimacs(fp, s);
+        int end_time = clock();
+        fseek(fp, 0, SEEK_END);
+        double seconds = (double)(end_time - start_time) / CLOCKS_PER_SEC;
+        printf("parse_dimacs | %.3f s | %d variables | %.1f MB/s\n", seconds,
+            s.n_variables(), ftell(fp) / (seconds > 0 ? seconds : 1e-9) / (1 << 20));
+        fclose(fp);
+        return 0;
+    }
+
+    if (bench_xor) {
+        // Random 3-XOR-SAT just below the threshold, with and without the 
+        // matrices (10 s each unless -time is given)
+        const int sizes[] = { 50, 100, 150, 200, 1000 };
+        for (int n : sizes) {
+            for (bool g : { true, false }) {
+                MyyuraSat::Solver s;
+                s.gaussian_elimination(g);
+                s.time_budget(seconds >= 0 ? seconds : 10);
+                s.xor_benchmark(n, n * 9 / 10, 2718281 + n);
+            }
+        }
+        return 0;
+    }
+
+    if (bench_propagate) {
+        FILE *fp = open_input(input);
+        MyyuraSat::Solver s;
+        parse_dimacs(fp, s);
+        fclose(fp);
+        s.propagation_benchmark(20000000);
+        return 0;
+    }
+
     MyyuraSat::Solver s;
+    s.branch_heuristic(branch);
+    s.restart_policy(restart);
+    if (trace_level >= 0) { s.trace(trace_level); }
+    if (subsumption_effort >= 0) { s.subsumption_effort(subsumption_effort); }
+    s.elimination(elimination);
+    s.blocked_elimination(blocked_elimination);
+    s.covered_elimination(covered_elimination);
+    s.probing(probing);
+    s.vivification(vivification);
+    s.gaussian_elimination(gauss);
+
+    // Before the first clause, LRAT numbers the input clauses
+    FILE *proof_out = NULL;
+    if (proof != NULL) {
+        proof_out = fopen(proof, "wb");
+        if (proof_out == NULL) {
+            fprintf(stderr, "ERROR! Could not open file: %s\n", proof);
+            exit(1);
+        }
+        s.proof(proof_out, proof_format);
+    }
     // s.add_empty_clause();
-    parse_dimacs(fp, s);
+    int load_start_time = clock();
+    load_problem(input, cache, s);
+    if (cache != NULL) {
+        printf("c load time             : %.3f s\n", (double)(clock() - load_start_time) / CLOCKS_PER_SEC);
+    }
     s.check_garbage();
     // s.print_clauses();
+
+    s.conflict_budget(conflicts);
+    s.propagation_budget(propagations);
+    s.memory_budget(megabytes << 20);
+    s.time_budget(seconds);
+    solver = &s;
+    signal(SIGINT, interrupt_handler);
+    signal(SIGTERM, interrupt_handler);
+
     int start_time = clock();
-    s.solve_test();
+    MyyuraSat::Vector<MyyuraSat::Literal> assumptions;
+    MyyuraSat::LiftedBoolean status = s.solve_limited(assumptions);
     int end_time = clock();
-    std::cout << (double)(end_time - start_time) / CLOCKS_PER_SEC << std::endl;
+    solver = NULL;
+
+    s.print_status();
+    printf("c solve time            : %.3f s\n", (double)(end_time - start_time) / CLOCKS_PER_SEC);
+    print_result(s, status);
+
+    // The trace ring is empty unless built with 'make debug'
+    if (trace_level >= 0) { s.dump_trace(stderr); }
 
     // s.clause_test();
 
     // s.garbage_collection_test();
 
     // s.subsumption_test();
+
+    // s.cache_test();
+    if (status == MyyuraSat::LIFTED_BOOLEAN_TRUE) { return 10; }
+    if (status == MyyuraSat::LIFTED_BOOLEAN_FALSE) { return 20; }
     return 0;
 }
\ No newline at end of file
@@ -14,11 +14,18 @@ inline bool Solver::is_removed(CRARef cr) const {
     return _ca[cr].mark() == 1;
 }
 
+inline Literal Solver::implied_literal(const Clause& c) const {
+    // Binary clauses are not reordered by 'propagate'
+    return (c.size() == 2 && !is_true(c[0])) ? c[1] : c[0];
+}
+
 inline bool Solver::is_locked(const Clause& c) const {
     // Working together with Watcher
-    return value(c[0]) == LIFTED_BOOLEAN_TRUE
-        && reason(c[0].variable()) != CRAREF_UNDEF
-        && _ca.lea(reason(c[0].variable())) == &c;
+    Literal p = implied_literal(c);
+    return is_true(p)
+        && reason(p.variable()) != CRAREF_UNDEF
+        && reason(p.variable()) != CRAREF_LAZY
+        && _ca.lea(reason(p.variable())) == &c;
 }
 
 bool Solver::_add_clause(Vector<Literal>& ps) {
@@ -26,28 +33,88 @@ bool Solver::_add_clause(Vector<Literal>& ps) {
         throw std::logic_error("Solver::_add_clause : decision level is not 0");
     }
 
+    // Active only while the scope is open
+    if (_scopes.size() > 0) { ps.push(~_scopes.back()); }
+
+    uint64_t id = _next_problem_id++;
+    if (lrat() && id >= _problem_ids_end && _next_clause_id > _problem_ids_end) {
+        throw std::logic_error("Solver::_add_clause : more problem clauses than declared for LRAT");
+    }
+    if (!_myyura) { return false; }
+
+    // A clause on an eliminated variable (or one a blocked clause may flip) 
+    // puts the variable back first
+    for (int k = 0; k < ps.size(); k++) {
+        if (is_extended(ps[k].variable())) { restore_variable(ps[k].variable()); }
+    }
+    if (!_myyura) { return false; }
+
     std::sort(ps.begin(), ps.end());
+    if (_proof != NULL) { ps.copy_to(_proof_literals); }
 
     // Check if clause is satisfied and remove false/duplicate literals
     // Bug here ？
     Literal p;
     int i, j;
+    bool shortened = false;
     for (i = j = 0, p = LITERAL_UNDEF; i < ps.size(); i++) {
         if (value(ps[i]) == LIFTED_BOOLEAN_TRUE || ps[i] == ~p) {
             return true;
         } else if (value(ps[i]) != LIFTED_BOOLEAN_FALSE && ps[i] != p) {
             ps[j++] = p = ps[i];
+        } else if (value(ps[i]) == LIFTED_BOOLEAN_FALSE) {
+            shortened = true;
         }
     }
     ps.shrink(i - j);
 
+    if (_proof != NULL && (shortened || ps.size() == 0)) {
+        // Without its false literals the clause is implied by the top-level
+        // units and the clause itself
+        _proof_hints.clear();
+        if (lrat()) {
+            for (i = 0; i < _proof_literals.size(); i++) {
+                if (value(_proof_literals[i]) == LIFTED_BOOLEAN_FALSE
+                    && (i == 0 || _proof_literals[i] != _proof_literals[i - 1])) {
+                    _proof_hints.push(_unit_id[_proof_literals[i].variable()]);
+                }
+            }
+            _proof_hints.push(id);
+        }
+
+        uint64_t original = id;
+        id = new_clause_id();
+        proof_add(ps, ps.size(), id);
+        if (ps.size() > 0) {
+            _proof->remove(_proof_literals, _proof_literals.size(), original);
+        }
+    }
+
     if (ps.size() == 0) {
         return _myyura = false;
     } else if (ps.size() == 1) {
         unchecked_enqueue(ps[0]);
-        return _myyura = (propagate() == CRAREF_UNDEF);
+        if (_proof != NULL) { _unit_id[ps[0].variable()] = id; }
+        // Propagated by 'end_bulk_load', there are no watches yet
+        if (_bulk_load) { return true; }
+
+        CRARef conflict = propagate();
+        if (_proof != NULL) {
+            if (conflict != CRAREF_UNDEF) {
+                proof_empty_clause(conflict);
+            } else if (lrat()) {
+                proof_units();
+            }
+        }
+        return _myyura = (conflict == CRAREF_UNDEF);
     } else {
         CRARef cr = _ca.alloc(ps, false);
+        if (_ca.clause_ids()) { _ca[cr].id(id); }
+
+        if (_bulk_load) {
+            _bulk_clauses.push(cr);
+            return true;
+        }
 
         /**
          * Subsumption
@@ -78,6 +145,17 @@ void Solver::remove_clause(CRARef cr) {
     Clause& c = _ca[cr];
     detach_clause_watcher(cr);
 
+    if (_proof != NULL) {
+        // A top-level unit needs its reason until it has a unit clause
+        if (is_locked(c)) { proof_units(); }
+        proof_remove(c);
+    }
+
+    // Don't leave pointers to free'd memory!
+    if (is_locked(c)) {
+        _variable_info[implied_literal(c).variable()].reason = CRAREF_UNDEF;
+    }
+
     c.mark(1);
     _ca.free(cr);
 }
@@ -115,7 +193,7 @@ void Solver::reloc_all(ClauseAllocator& to) {
          * Note: it is not safe to call 'locked()' on a relocated clause. This 
          * is why we keep 'dangling' reasons here. It is safe and does not hurt.
          */
-        if (reason(v) != CRAREF_UNDEF && 
+        if (reason(v) != CRAREF_UNDEF && reason(v) != CRAREF_LAZY &&
             (_ca[reason(v)].reloced() || is_locked(_ca[reason(v)]))) {
             if (is_removed(reason(v))) {
                 throw std::logic_error("Solver::reloc_all : reason is already removed!");
@@ -124,6 +202,11 @@ void Solver::reloc_all(ClauseAllocator& to) {
             _ca.reloc(_variable_info[v].reason, to);
         }
     }
+    // (a reason replaced by 'hyper_binary_resolution' is kept until it is freed)
+    for (int i = 0; i < _xor_implied.size(); i++) {
+        if (_xor_implied[i].reason != CRAREF_UNDEF) { _ca.reloc(_xor_implied[i].reason, to); }
+    }
+    if (_xor_conflict != CRAREF_UNDEF) { _ca.reloc(_xor_conflict, to); }
 
     int i, j;
     // Learnts:
@@ -144,6 +227,27 @@ void Solver::reloc_all(ClauseAllocator& to) {
         }
     }
     _clauses.shrink(i - j);
+
+    // Subsumption queues:
+    CSet* queues[] = { &_added, &_strengthened };
+    for (CSet* q : queues) {
+        CSet relocated;
+        for (CRARef cr : *q) {
+            if (!is_removed(cr)) {
+                _ca.reloc(cr, to);
+                relocated.insert(cr);
+            }
+        }
+        q->swap(relocated);
+    }
+
+    for (i = j = 0; i < _subsumption_queue.size(); i++) {
+        if (!is_removed(_subsumption_queue[i])) {
+            _ca.reloc(_subsumption_queue[i], to);
+            _subsumption_queue[j++] = _subsumption_queue[i];
+        }
+    }
+    _subsumption_queue.shrink(i - j);
 }
 
 void Solver::garbage_collect(void) {
@@ -153,8 +257,10 @@ void Solver::garbage_collect(void) {
      * reallocations for the new region:
      */
     ClauseAllocator to(_ca.size() - _ca.wasted());
+    to.clause_ids(_ca.clause_ids());
 
     reloc_all(to);
+    _trace.log(TRACE_GC, 1, "garbage collection: %u words -> %u words", _ca.size(), to.size());
     to.move_to(_ca);
 }
 
@@ -169,10 +275,28 @@ void Solver::garbage_collect(void) {
 
 // }
 
+inline int Solver::n_scopes(void) const {
+    return _scopes.size();
+}
+
 inline int Solver::n_variables(void) const {
     return _next_variable;
 }
 
+inline void Solver::reserve(int n_clauses, uint64_t n_literals) {
+    _ca.reserve(n_clauses, n_literals);
+    _clauses.reserve(_clauses.size() + n_clauses);
+}
+
+inline void Solver::begin_bulk_load(void) {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::begin_bulk_load : decision level is not 0");
+    }
+
+    _bulk_load = true;
+    _bulk_start = _ca.size();
+}
+
 inline bool Solver::add_clause(const Vector<Literal>& ps) {
     ps.copy_to(_add_clause_temp);
     return _add_clause(_add_clause_temp);
@@ -229,6 +353,10 @@ inline LiftedBoolean Solver::model_value(Literal p) const {
     return _model_value[p.variable()] ^ p.sign();
 }
 
+inline const LSet& Solver::conflict(void) const {
+    return _conflict;
+}
+
 inline int Solver::n_assigns(void) const {
     return _trail.size();
 }
@@ -237,18 +365,32 @@ inline int Solver::n_clauses(void) const {
     return _n_clauses;
 }
 
+inline bool Solver::solve(const Vector<Literal>& assumps) {
+    budget_off();
+    assumps.copy_to(_assumptions);
+    return _solve() == LIFTED_BOOLEAN_TRUE;
+}
+
+inline LiftedBoolean Solver::solve_limited(const Vector<Literal>& assumps) {
+    assumps.copy_to(_assumptions);
+    return _solve();
+}
+
 inline bool Solver::solve(void) {
+    budget_off();
     _assumptions.clear();
     return _solve() == LIFTED_BOOLEAN_TRUE;
 }
 
 inline bool Solver::solve(Literal p) {
+    budget_off();
     _assumptions.clear();
     _assumptions.push(p);
     return _solve() == LIFTED_BOOLEAN_TRUE;
 }
 
 inline bool Solver::solve(Literal p, Literal q) {
+    budget_off();
     _assumptions.clear();
     _assumptions.push(p);
     _assumptions.push(q);
@@ -256,6 +398,7 @@ inline bool Solver::solve(Literal p, Literal q) {
 }
 
 inline bool Solver::solve(Literal p, Literal q, Literal r) {
+    budget_off();
     _assumptions.clear();
     _assumptions.push(p);
     _assumptions.push(q);
@@ -263,6 +406,41 @@ inline bool Solver::solve(Literal p, Literal q, Literal r) {
     return _solve() == LIFTED_BOOLEAN_TRUE;
 }
 
+inline void Solver::conflict_budget(int64_t n) {
+    _conflict_budget = n < 0 ? -1 : (int64_t)_n_conflicts + n;
+}
+
+inline void Solver::propagation_budget(int64_t n) {
+    _propagation_budget = n < 0 ? -1 : (int64_t)_n_propagations + n;
+}
+
+inline void Solver::memory_budget(uint64_t bytes) {
+    _memory_budget = bytes;
+}
+
+inline void Solver::time_budget(double seconds) {
+    _time_budget_on = seconds >= 0;
+    if (_time_budget_on) {
+        _time_budget = std::chrono::steady_clock::now() + 
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    }
+}
+
+inline void Solver::budget_off(void) {
+    _conflict_budget = -1;
+    _propagation_budget = -1;
+    _memory_budget = 0;
+    _time_budget_on = false;
+}
+
+inline void Solver::interrupt(void) {
+    _interrupted.store(true, std::memory_order_relaxed);
+}
+
+inline void Solver::clear_interrupt(void) {
+    _interrupted.store(false, std::memory_order_relaxed);
+}
+
 inline void Solver::print_clauses(void) const {
     std::cout << "print clauses begin: ==================================" << std::endl;
     for (int i = 0; i < _clauses.size(); i++) {
@@ -286,20 +464,179 @@ inline void Solver::check_garbage(double gf) {
     }
 }
 
+inline void Solver::dump_trace(FILE *out) const {
+    _trace.dump(out);
+}
+
+inline void Solver::trace(int level, unsigned categories) {
+    _trace.level(level);
+    _trace.categories(categories);
+}
+
+inline void Solver::branch_heuristic(BranchHeuristic h) {
+    // Only the active heuristic is kept up to date during search
+    if (h == BRANCH_VSIDS && _branch_heuristic != BRANCH_VSIDS) {
+        for (Variable x = 0; x < n_variables(); x++) {
+            insert_variable_order(x);
+        }
+    } else if (h == BRANCH_VMTF && _branch_heuristic != BRANCH_VMTF) {
+        _vmtf_search = _vmtf_last;
+    }
+
+    _branch_heuristic = h;
+}
+
+inline void Solver::restart_policy(RestartPolicy p) {
+    _restart_policy = p;
+}
+
+inline void Solver::subsumption_effort(int64_t visits) {
+    _subsumption_effort = visits;
+}
+
+inline void Solver::elimination(bool on) {
+    _elimination = on;
+}
+
+inline void Solver::blocked_elimination(bool on) {
+    _blocked_elimination = on;
+}
+
+inline void Solver::covered_elimination(bool on) {
+    _covered_elimination = on;
+}
+
+inline void Solver::probing(bool on) {
+    _probing = on;
+}
+
+inline void Solver::vivification(bool on) {
+    _vivification = on;
+}
+
+inline void Solver::gaussian_elimination(bool on) {
+    _gauss = on;
+}
+
+inline void Solver::frozen(Variable x, bool b) {
+    if (b && is_extended(x)) { restore_variable(x); }
+    _frozen[x] = (_frozen[x] & ~1) | (char)b;
+}
+
+inline bool Solver::is_eliminated(Variable x) const {
+    return _eliminated[x] >= 0;
+}
+
 // inline minor methods end
 
 // major methods
 Solver::Solver(void) :
     _myyura(true),
-    _queue_head(0),
-    _next_variable(0),
-    _garbage_frac(0.0),
     // May not good to write like this
     _watches([&](const _Watcher& w) -> bool { return _ca[w.cref].mark() == 1; }),
-    _occur_lit([&](const CRARef& cr) -> bool { return _ca[cr].mark() == 1; }) 
+    _queue_head(0),
+    _next_variable(0),
+    _variable_inc(1.0),
+    _variable_decay(0.95),
+    _order_heap(_VariableOrderLt(_activity)),
+    _vmtf_first(VARIABLE_UNDEF),
+    _vmtf_last(VARIABLE_UNDEF),
+    _vmtf_search(VARIABLE_UNDEF),
+    _vmtf_stamp(0),
+    _branch_heuristic(BRANCH_VSIDS),
+    _n_decision_variables(0),
+    _n_clauses(0),
+    _n_decisions(0),
+    _n_conflicts(0),
+    _n_propagations(0),
+    _n_restarts(0),
+    _n_blocked_restarts(0),
+    _n_restart_trail(0),
+    _n_max_literals(0),
+    _n_total_literals(0),
+    _n_subsumed(0),
+    _n_strengthened(0),
+    _n_eliminated(0),
+    _n_failed_literals(0),
+    _n_hyper_binaries(0),
+    _n_substituted(0),
+    _n_vivified(0),
+    _n_vivified_literals(0),
+    _n_blocked(0),
+    _n_covered(0),
+    _n_xors(0),
+    _n_xor_propagations(0),
+    _n_xor_conflicts(0),
+    _restart_policy(RESTART_GLUCOSE),
+    _restart_first(100),
+    _restart_inc(2),
+    _restart_index(0),
+    _lbd_fast(1.0 / 32),
+    _lbd_slow(1.0 / 4096),
+    _trail_slow(1.0 / 5000),
+    _lbd_window(0),
+    _restart_margin(1.25),
+    _restart_block(1.4),
+    _lbd_stamp(0),
+    _clause_inc(1),
+    _clause_decay(0.999),
+    _core_lbd(2),
+    _tier2_lbd(6),
+    _next_reduce_db(2000),
+    _reduce_interval(2000),
+    _reduce_inc(300),
+    _n_reduce_db(0),
+    _n_removed_learnts(0),
+    _conflict_budget(-1),
+    _propagation_budget(-1),
+    _memory_budget(0),
+    _time_budget_on(false),
+    _budget_checks(0),
+    _interrupted(false),
+    _bulk_load(false),
+    _bulk_start(0),
+    _simplify_assigns(-1),
+    _simplify_propagations(0),
+    _occur_lit([&](const CRARef& cr) -> bool { return _ca[cr].mark() == 1; }),
+    _subsumption_effort(3000000),
+    _subsumption_head(0),
+    _elimination(true),
+    _elim_grow(0),
+    _elim_clause_limit(20),
+    _elim_occurence_limit(1000),
+    _elimination_effort(10000000),
+    _blocked_elimination(true),
+    _covered_elimination(true),
+    _cover_limit(64),
+    _blocked_effort(10000000),
+    _probing(true),
+    _next_probe(0),
+    _probe_interval(5000),
+    _probe_ratio(0.1),
+    _probe_min_ticks(20000),
+    _probe_propagations(0),
+    _probe_next(0),
+    _vivification(true),
+    _vivify_next(0),
+    _gauss(true),
+    _xor_extracted(false),
+    _xor_size_limit(6),
+    _xor_column_limit(4096),
+    _xor_head(0),
+    _xor_conflict(CRAREF_UNDEF),
+    _xor_stamp(0),
+    _proof(NULL),
+    _next_problem_id(1),
+    _problem_ids_end(0),
+    _next_clause_id(0),
+    _proof_units_head(0),
+    _garbage_frac(0.20)
     {}
 
-Solver::~Solver() {}
+Solver::~Solver() {
+    // Writes out the rest of the proof
+    delete _proof;
+}
 
 /**
  * Creates a new SAT variable in the solver. If 'decision' is cleared, variable 
@@ -315,11 +652,239 @@ Variable Solver::new_variable(LiftedBoolean upol, bool dvar) {
     _occur_lit.init(Literal(v, true));
     _touched.insert(v, true);
     _touched_list.push(v);
+    _elim_touched.insert(v, true);
+    _elim_touched_list.push(v);
+    _frozen.insert(v, 0);
+    _eliminated.insert(v, -1);
+    _witness.insert(v, 0);
+    _xor_matrix.insert(v, -1);
+    _xor_column.insert(v, -1);
+    _xor_implied_index.insert(v, -1);
     _assigns.insert(v, LIFTED_BOOLEAN_UNDEF);
+    _values.insert(Literal(v, false), 0, 0);
+    _values.insert(Literal(v, true), 0, 0);
     _variable_info.insert(v, _VariableInfo(CRAREF_UNDEF, 0));
-    _polarity.insert(v, false);
+    _polarity.insert(v, upol != LIFTED_BOOLEAN_FALSE);
+    _decision.insert(v, (char)dvar);
+    _activity.insert(v, 0.0);
     _seen.insert(v, 0);
+    _unit_id.insert(v, 0);
+    _level_stamp.grow_to(v + 2, 0);
     _trail.reserve(v + 1);
+    insert_variable_order(v);
+    _vmtf_links.insert(v, _VmtfLink());
+    vmtf_enqueue(v);
+    _vmtf_search = v;
+    _n_decision_variables += dvar;
 
     return v;
+}
+
+/**
+ * push : (void) -> [void]
+ * 
+ * Description:
+ *  Open a scope with a fresh activation variable (not a decision variable).
+ */
+void Solver::push(void) {
+    if (_proof != NULL) {
+        throw std::logic_error("Solver::push : scopes are not supported while writing a proof");
+    }
+
+    _scopes.push(Literal(new_variable(LIFTED_BOOLEAN_UNDEF, false)));
+}
+
+/**
+ * pop : (n_scopes : int) -> [void]
+ * 
+ * Description:
+ *  Close the innermost 'n_scopes' scopes. The activation literals are set to 
+ *  false at the top level, which satisfies every clause of the scopes and 
+ *  every learnt clause derived from one (the activation literal is an 
+ *  assumption, so its negation is never resolved away). These are removed in 
+ *  one sweep with lazy detaching, the watchers are cleaned when they are 
+ *  visited next or by the garbage collection. The occurence lists are 
+ *  cleaned here, the garbage collection keeps everything still in them.
+ */
+void Solver::pop(int n_scopes) {
+    if (n_scopes > _scopes.size()) {
+        throw std::logic_error("Solver::pop : there are not that many scopes");
+    }
+
+    cancel_until(0);
+
+    for (int i = 0; i < n_scopes; i++) {
+        Literal a = _scopes.back();
+        _scopes.pop();
+        if (!_myyura) { continue; }
+
+        if (value(a) == LIFTED_BOOLEAN_UNDEF) { unchecked_enqueue(~a); }
+
+        const Vector<CRARef>& crs = _occur_lit[~a];
+        for (int j = 0; j < crs.size(); j++) {
+            if (is_removed(crs[j])) { continue; }
+            const Clause& c = _ca[crs[j]];
+            for (int k = 0; k < c.size(); k++) { _occur_lit.smudge(c[k]); }
+            remove_clause(crs[j]);
+        }
+    }
+    if (!_myyura) { return; }
+
+    // Nothing contains the activation literals positively, this can't fail
+    _myyura = propagate() == CRAREF_UNDEF;
+
+    int i, j;
+    for (i = j = 0; i < _learnts.size(); i++) {
+        if (is_satisfied(_ca[_learnts[i]]) == LIFTED_BOOLEAN_TRUE) {
+            remove_clause(_learnts[i]);
+        } else {
+            _learnts[j++] = _learnts[i];
+        }
+    }
+    _learnts.shrink(i - j);
+
+    _occur_lit.clean_all();
+    check_garbage();
+}
+
+/**
+ * end_bulk_load : (void) -> [void]
+ *
+ * Description:
+ *  Finish a bulk load started by 'begin_bulk_load'. The pending clauses are
+ *  already sorted and free of duplicate/false literals (by '_add_clause'), here
+ *  duplicate clauses are removed by sorting the clause list, subsumed clauses
+ *  by one backward subsumption pass over the occurence lists (instead of an 
+ *  'is_subsumed' check per added clause), then the remaining clauses are 
+ *  watched and the top-level units propagated.
+ */
+void Solver::end_bulk_load(void) {
+    if (!_bulk_load) {
+        throw std::logic_error("Solver::end_bulk_load : not in bulk load mode");
+    }
+    _bulk_load = false;
+
+    // Duplicates end up next to each other
+    std::sort(_bulk_clauses.begin(), _bulk_clauses.end(), [&](CRARef x, CRARef y) -> bool {
+        const Clause& c = _ca[x];
+        const Clause& d = _ca[y];
+        if (c.size() != d.size()) { return c.size() < d.size(); }
+        if (c.abstraction() != d.abstraction()) { return c.abstraction() < d.abstraction(); }
+
+        for (int i = 0; i < c.size(); i++) {
+            if (c[i] != d[i]) { return c[i] < d[i]; }
+        }
+
+        return x < y;
+    });
+
+    int i, j;
+    for (i = j = 0; i < _bulk_clauses.size(); i++) {
+        const Clause& c = _ca[_bulk_clauses[i]];
+        if (j > 0) {
+            const Clause& d = _ca[_bulk_clauses[j - 1]];
+            int k = 0;
+            if (c.size() == d.size() && c.abstraction() == d.abstraction()) {
+                for (; k < c.size() && c[k] == d[k]; k++) {}
+            }
+
+            if (k == c.size()) {
+                if (_proof != NULL) { proof_remove(c); }
+                _ca[_bulk_clauses[i]].mark(1);
+                _ca.free(_bulk_clauses[i]);
+                continue;
+            }
+        }
+
+        _bulk_clauses[j++] = _bulk_clauses[i];
+    }
+    _bulk_clauses.shrink(i - j);
+
+    /**
+     * Occurence lists and watches sized once from the literal counts. The 
+     * clauses don't go into '_added': the subsumption below already covers
+     * them.
+     */
+    Vector<int> counts(2 * n_variables(), 0);
+    for (i = 0; i < _bulk_clauses.size(); i++) {
+        const Clause& c = _ca[_bulk_clauses[i]];
+        for (int k = 0; k < c.size(); k++) { counts[c[k].to_int()]++; }
+    }
+    for (Variable x = 0; x < n_variables(); x++) {
+        for (int sign = 0; sign < 2; sign++) {
+            Literal p(x, sign);
+            _occur_lit[p].reserve(_occur_lit[p].size() + counts[p.to_int()]);
+            if (counts[p.to_int()] > 0) { touch(p); }
+        }
+    }
+    for (i = 0; i < _bulk_clauses.size(); i++) {
+        const Clause& c = _ca[_bulk_clauses[i]];
+        for (int k = 0; k < c.size(); k++) { _occur_lit[c[k]].push(_bulk_clauses[i]); }
+    }
+
+    subsume_batch(_bulk_clauses);
+
+    counts.clear();
+    counts.grow_to(2 * n_variables(), 0);
+    for (i = j = 0; i < _bulk_clauses.size(); i++) {
+        if (!is_removed(_bulk_clauses[i])) {
+            const Clause& c = _ca[_bulk_clauses[i]];
+            counts[(~c[0]).to_int()]++;
+            counts[(~c[1]).to_int()]++;
+            _bulk_clauses[j++] = _bulk_clauses[i];
+        }
+    }
+    _bulk_clauses.shrink(i - j);
+    for (Variable x = 0; x < n_variables(); x++) {
+        for (int sign = 0; sign < 2; sign++) {
+            Literal p(x, sign);
+            _watches[p].reserve(_watches[p].size() + counts[p.to_int()]);
+        }
+    }
+
+    _clauses.reserve(_clauses.size() + _bulk_clauses.size());
+    for (i = 0; i < _bulk_clauses.size(); i++) {
+        _clauses.push(_bulk_clauses[i]);
+        attach_clause_watcher(_bulk_clauses[i]);
+    }
+    _bulk_clauses.clear(true);
+
+    if (_myyura) {
+        CRARef conflict = propagate();
+        if (_proof != NULL) {
+            if (conflict != CRAREF_UNDEF) {
+                proof_empty_clause(conflict);
+            } else if (lrat()) {
+                proof_units();
+            }
+        }
+        _myyura = conflict == CRAREF_UNDEF;
+    }
+}
+
+void Solver::print_status(void) const {
+    printf("c restarts              : %llu (%llu blocked)\n", 
+        (unsigned long long)_n_restarts, (unsigned long long)_n_blocked_restarts);
+    printf("c avg. trail at restart : %.1f\n", 
+        _n_restarts == 0 ? 0.0 : (double)_n_restart_trail / _n_restarts);
+    printf("c conflicts             : %llu\n", (unsigned long long)_n_conflicts);
+    printf("c reductions            : %llu (%llu learnts removed)\n", 
+        (unsigned long long)_n_reduce_db, (unsigned long long)_n_removed_learnts);
+    printf("c decisions             : %llu\n", (unsigned long long)_n_decisions);
+    printf("c conflict literals     : %llu (%.2f %% deleted)\n", (unsigned long long)_n_total_literals, 
+        _n_max_literals == 0 ? 0.0 : (_n_max_literals - _n_total_literals) * 100 / (double)_n_max_literals);
+    printf("c propagations          : %llu\n", (unsigned long long)_n_propagations);
+    printf("c subsumed clauses      : %llu (%llu strengthened)\n", 
+        (unsigned long long)_n_subsumed, (unsigned long long)_n_strengthened);
+    printf("c eliminated variables  : %llu\n", (unsigned long long)_n_eliminated);
+    printf("c blocked clauses       : %llu (%llu covered)\n", 
+        (unsigned long long)_n_blocked, (unsigned long long)_n_covered);
+    printf("c substituted variables : %llu\n", (unsigned long long)_n_substituted);
+    printf("c failed literals       : %llu (%llu hyper binaries)\n", 
+        (unsigned long long)_n_failed_literals, (unsigned long long)_n_hyper_binaries);
+    printf("c vivified clauses      : %llu (%llu literals removed)\n", 
+        (unsigned long long)_n_vivified, (unsigned long long)_n_vivified_literals);
+    printf("c xor constraints       : %llu (%d matrices, %llu propagations, %llu conflicts)\n", 
+        (unsigned long long)_n_xors, _xor_matrices.size(), 
+        (unsigned long long)_n_xor_propagations, (unsigned long long)_n_xor_conflicts);
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+/**
+ * The SAT solver
+ * Binary CNF cache
+ *
+ * The normalized problem (variables, top-level trail and the clauses as they
+ * are after '_add_clause', i.e. sorted, deduplicated and not subsumed) is
+ * written out as raw clause allocator words. Loading it back maps the file and
+ * copies the words into the clause allocator in one go, none of the per-clause
+ * work of '_add_clause' is repeated.
+ *
+ * Layout (native byte order, the cache is not meant to be portable):
+ *  _CacheHeader
+ *  char input[input_length]       - path of the input, padded to 4 bytes
+ *  uint32_t trail[n_trail]        - top-level assignments (Literal::to_int)
+ *  uint32_t clauses[n_clauses]    - references into the words below
+ *  uint32_t words[n_words]        - clause allocator region
+ */
+
+#include "../include/core/solver.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace MyyuraSat;
+
+namespace {
+
+const char CACHE_MAGIC[8] = { 'M', 'Y', 'S', 'A', 'T', 'C', 'N', 'F' };
+
+/**
+ * Bump on any change of the layout above, of the Clause header or of the
+ * clause allocator words. Older caches are rejected (and rebuilt by main).
+ */
+const uint32_t CACHE_VERSION = 2;
+
+struct _CacheHeader {
+    char magic[8];
+    uint32_t version;
+    // sizeof(Clause), a cheap guard against a changed Clause layout
+    uint32_t clause_size;
+    // The input the cache was built from (see 'input_key')
+    uint64_t input_device;
+    uint64_t input_inode;
+    uint64_t input_size;
+    int64_t input_mtime_sec;
+    int64_t input_mtime_nsec;
+    uint32_t input_length;
+    uint32_t extra_clause_field;
+    uint32_t ok;
+    uint32_t n_variables;
+    uint32_t n_trail;
+    uint32_t n_clauses;
+    uint32_t n_words;
+};
+
+/**
+ * input_key : (input : const char*) (header : _CacheHeader&) -> [bool]
+ *
+ * Description:
+ *  Fill in the fields of 'header' that identify 'input': device, inode, size
+ *  and modification time (to the nanosecond) of the file, and the length of
+ *  its path. A copy of the file, or a file rewritten with the same size 
+ *  within a second, differs in at least one of them. No input (NULL) leaves
+ *  them 0. Returns false if 'input' can't be stat'ed.
+ */
+bool input_key(const char *input, _CacheHeader& header) {
+    if (input == NULL) { return true; }
+
+    struct stat st;
+    if (stat(input, &st) != 0) { return false; }
+
+    header.input_device = (uint64_t)st.st_dev;
+    header.input_inode = (uint64_t)st.st_ino;
+    header.input_size = (uint64_t)st.st_size;
+    header.input_mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    header.input_mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    header.input_length = std::strlen(input);
+    return true;
+}
+
+// The path of the input takes whole words
+inline uint32_t input_words(const _CacheHeader& header) {
+    return (header.input_length + 3) / 4;
+}
+
+}
+
+/**
+ * save_cache : (path : const char*, input : const char*) -> [bool]
+ *
+ * Description:
+ *  Write the problem clauses and the top-level trail to 'path'. Learnt clauses
+ *  are not saved. The cache remembers the file 'input' the problem was read
+ *  from (see 'input_key'), 'load_cache' only accepts the same file unchanged.
+ *  Returns false if the file couldn't be written or 'input' stat'ed.
+ */
+bool Solver::save_cache(const char *path, const char *input) const {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::save_cache : decision level is not 0");
+    }
+
+    // Compact copy of the problem clauses, without the wasted words
+    ClauseAllocator region(_ca.size() - _ca.wasted() + 1);
+    region.extra_clause_field(_ca.extra_clause_field());
+    Vector<CRARef> crefs;
+    for (int i = 0; i < _clauses.size(); i++) {
+        if (!is_removed(_clauses[i])) {
+            crefs.push(region.alloc(_ca[_clauses[i]]));
+        }
+    }
+
+    Vector<uint32_t> trail;
+    for (int i = 0; i < _trail.size(); i++) {
+        trail.push((uint32_t)_trail[i].to_int());
+    }
+
+    _CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.clause_size = sizeof(Clause);
+    header.extra_clause_field = _ca.extra_clause_field();
+    header.ok = _myyura;
+    header.n_variables = n_variables();
+    header.n_trail = trail.size();
+    header.n_clauses = crefs.size();
+    header.n_words = region.size();
+    if (!input_key(input, header)) { return false; }
+
+    Vector<uint32_t> input_path(input_words(header), 0);
+    if (header.input_length > 0) { std::memcpy((uint32_t*)input_path, input, header.input_length); }
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) { return false; }
+
+    bool written = fwrite(&header, sizeof(header), 1, out) == 1
+        && fwrite((uint32_t*)input_path, sizeof(uint32_t), input_path.size(), out) == (size_t)input_path.size()
+        && fwrite((uint32_t*)trail, sizeof(uint32_t), trail.size(), out) == (size_t)trail.size()
+        && fwrite((CRARef*)crefs, sizeof(CRARef), crefs.size(), out) == (size_t)crefs.size()
+        && fwrite(region.data(), sizeof(uint32_t), region.size(), out) == region.size();
+
+    return (fclose(out) == 0) && written;
+}
+
+/**
+ * load_cache : (path : const char*, input : const char*) -> [bool]
+ *
+ * Description:
+ *  Load a problem written by 'save_cache' into an empty solver. Returns false
+ *  (and leaves the solver empty) if there is no usable cache at 'path': the
+ *  file is missing, was written by another version or for another input
+ *  (or for 'input' before it changed), or is truncated. A cache is never used
+ *  while writing a proof.
+ */
+bool Solver::load_cache(const char *path, const char *input) {
+    if (n_variables() != 0 || _clauses.size() != 0) {
+        throw std::logic_error("Solver::load_cache : the solver is not empty");
+    }
+
+    // The proof needs the problem clauses in input order
+    if (_proof != NULL) { return false; }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { return false; }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(_CacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) { return false; }
+
+    const _CacheHeader& header = *(const _CacheHeader*)map;
+    const char *input_path = (const char*)map + sizeof(_CacheHeader);
+    const uint32_t *trail = (const uint32_t*)input_path + input_words(header);
+    const CRARef *crefs = trail + header.n_trail;
+    const uint32_t *words = crefs + header.n_clauses;
+
+    _CacheHeader key;
+    std::memset(&key, 0, sizeof(key));
+    bool same_input = input_key(input, key)
+        && header.input_device == key.input_device
+        && header.input_inode == key.input_inode
+        && header.input_size == key.input_size
+        && header.input_mtime_sec == key.input_mtime_sec
+        && header.input_mtime_nsec == key.input_mtime_nsec
+        && header.input_length == key.input_length;
+
+    // (the input path is only read once its length is known to fit)
+    uint64_t expected = sizeof(_CacheHeader) + sizeof(uint32_t) * ((uint64_t)input_words(header) 
+        + header.n_trail + header.n_clauses + header.n_words);
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+        || header.version != CACHE_VERSION
+        || header.clause_size != sizeof(Clause)
+        || header.extra_clause_field != (uint32_t)_ca.extra_clause_field()
+        || (uint64_t)st.st_size != expected
+        || !same_input
+        || (key.input_length > 0 && std::memcmp(input_path, input, key.input_length) != 0)) {
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    _trail.reserve(header.n_variables);
+    for (; n_variables() < (int)header.n_variables;) {
+        new_variable();
+    }
+
+    for (uint32_t i = 0; i < header.n_trail; i++) {
+        Literal p(trail[i] >> 1, trail[i] & 1);
+        if (value(p) == LIFTED_BOOLEAN_UNDEF) {
+            unchecked_enqueue(p);
+        }
+    }
+
+    // One copy of the whole region instead of an allocation per clause
+    CRARef base = header.n_words == 0 ? 0 : _ca.append(words, header.n_words);
+    _clauses.reserve(header.n_clauses);
+    for (uint32_t i = 0; i < header.n_clauses; i++) {
+        CRARef cr = base + crefs[i];
+        _clauses.push(cr);
+        attach_clause_watcher(cr);
+        attach_clause_occlit(cr);
+    }
+
+    bool ok = header.ok;
+    munmap(map, st.st_size);
+
+    // The trail was saved after propagation, so this finds nothing new
+    _myyura = ok && propagate() == CRAREF_UNDEF;
+
+    return true;
+}
@@ -6,16 +6,63 @@
 #include "../include/core/solver.hpp"
 #include "../include/util/algorithm.hpp"
 
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
 using namespace MyyuraSat;
 
+/**
+ * pick_branch_literal_occurence : (void) -> [Literal]
+ *
+ * Description:
+ *  The original branching heuristic, pick the unassigned variable occuring in
+ *  the most clauses. It scans the whole clause database for every decision, so
+ *  it is only used for debugging (see BRANCH_OCCURENCE).
+ */
+Literal Solver::pick_branch_literal_occurence(void) {
+    Variable v = VARIABLE_UNDEF;
+    int max_activity = 0;
+
+    for (Variable i = 0; i < n_variables(); i++) {
+        if (value(i) != LIFTED_BOOLEAN_UNDEF) { continue; }
+
+        int activity = 0;
+        for (int j = 0; j < _clauses.size(); j++) {
+            if (is_removed(_clauses[j])) { continue; }
+            Clause& c = _ca[_clauses[j]];
+            
+            for (int k = 0; k < c.size(); k++) {
+                if (c[k].variable() == i) { 
+                    activity++; 
+                    break;
+                }
+            }
+        }
+        if (activity > max_activity) {
+            v = i;
+            max_activity = activity;
+        }
+    }
+
+    if (v != VARIABLE_UNDEF) {
+        _polarity[v] = !_polarity[v];
+        return _polarity[v] ? Literal(v) : ~Literal(v);
+    }
+
+    return LITERAL_UNDEF;
+}
+
 bool Solver::solve_test(void) {
     // std::cout << "ca size: " << _ca.size() << std::endl;
     std::cout << "Start search! ==================" << std::endl;
-    LiftedBoolean status = search(100);
+    LiftedBoolean status = _solve();
     std::cout << "Finished search! ===============" << std::endl;
     if (status == LIFTED_BOOLEAN_TRUE) {
         for (int i = 0; i < n_variables(); i++) {
-            if (_assigns[i] == LIFTED_BOOLEAN_TRUE) {
+            if (_model_value[i] == LIFTED_BOOLEAN_TRUE) {
                 printf("%d ", i + 1);
             } else {
                 printf("-%d ", i + 1);
@@ -25,6 +72,9 @@ bool Solver::solve_test(void) {
     } else if (status == LIFTED_BOOLEAN_FALSE) {
         printf("UNSAT\n");
     }
+    print_status();
+
+    return status == LIFTED_BOOLEAN_TRUE;
 }
 
 void Solver::clause_test(void) {
@@ -96,4 +146,181 @@ void Solver::subsumption_test(void) {
     print_clauses();
     subsume0(_clauses[1]);
     print_clauses();
-}
\ No newline at end of file
+}
+
+/**
+ * cache_test : (void) -> [bool]
+ * 
+ * Description:
+ *  Round trip of a small problem through the binary cache, keyed by a
+ *  temporary input file. The cache must then be rejected for another file of
+ *  the same size and modification time, and for the input rewritten within
+ *  the same second. Returns true if all of it holds.
+ */
+bool Solver::cache_test(void) {
+    const char content[] = "p cnf 2 2\n1 2 0\n-1 0\n";
+    char input[] = "/tmp/myyurasat_input_XXXXXX";
+    char other[] = "/tmp/myyurasat_other_XXXXXX";
+    char cache[] = "/tmp/myyurasat_cache_XXXXXX";
+    int fds[3] = { mkstemp(input), mkstemp(other), mkstemp(cache) };
+    bool ok = fds[0] >= 0 && fds[1] >= 0 && fds[2] >= 0;
+    for (int i = 0; i < 2 && ok; i++) {
+        ok = write(fds[i], content, sizeof(content) - 1) == (ssize_t)sizeof(content) - 1;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (fds[i] >= 0) { close(fds[i]); }
+    }
+
+    Solver a;
+    a.new_variable();
+    a.new_variable();
+    Vector<Literal> A = {Literal(0), Literal(1)};
+    Vector<Literal> B = {~Literal(0)};
+    a.add_clause(A);
+    a.add_clause(B);
+    ok = ok && a.save_cache(cache, input);
+
+    Solver b;
+    bool loaded = ok && b.load_cache(cache, input);
+    printf("cache round trip        : %s\n", loaded ? "ok" : "FAILED");
+    ok = loaded && b.n_variables() == 2 && b._clauses.size() == a._clauses.size()
+        && b._trail.size() == a._trail.size() && b._trail[0] == a._trail[0];
+
+    // Same size and modification time, another file
+    struct stat st;
+    bool stale = ok && stat(input, &st) == 0;
+    struct timespec times[2] = { st.st_atim, st.st_mtim };
+    stale = stale && utimensat(AT_FDCWD, other, times, 0) == 0;
+    Solver c;
+    stale = stale && !c.load_cache(cache, other) && c.n_variables() == 0;
+
+    // The same file rewritten in the same second
+    times[1].tv_nsec = (times[1].tv_nsec + 1) % 1000000000;
+    stale = stale && utimensat(AT_FDCWD, input, times, 0) == 0;
+    Solver d;
+    stale = stale && !d.load_cache(cache, input) && d.n_variables() == 0;
+    printf("cache stale key         : %s\n", stale ? "ok" : "FAILED");
+
+    unlink(input);
+    unlink(other);
+    unlink(cache);
+    return ok && stale;
+}
+
+/**
+ * branch_benchmark : (h : BranchHeuristic) -> [void]
+ * 
+ * Description:
+ *  Search with the branching heuristic h and report decisions/sec and 
+ *  conflicts/sec. Run it on freshly parsed solvers of the same input to 
+ *  compare the heuristics.
+ */
+void Solver::branch_benchmark(BranchHeuristic h) {
+    const char *names[] = { "vsids", "vmtf", "occurence" };
+    branch_heuristic(h);
+
+    uint64_t decisions = _n_decisions;
+    uint64_t conflicts = _n_conflicts;
+    clock_t start_time = clock();
+    LiftedBoolean status = _solve();
+    double seconds = (double)(clock() - start_time) / CLOCKS_PER_SEC;
+
+    decisions = _n_decisions - decisions;
+    conflicts = _n_conflicts - conflicts;
+    if (seconds <= 0) { seconds = 1e-9; }
+
+    printf("branch %-9s | %s | %.3f s | decisions %llu (%.0f/s) | conflicts %llu (%.0f/s)\n",
+        names[h], 
+        status == LIFTED_BOOLEAN_TRUE ? "SAT  " : (status == LIFTED_BOOLEAN_FALSE ? "UNSAT" : "UNDEF"),
+        seconds,
+        (unsigned long long)decisions, decisions / seconds,
+        (unsigned long long)conflicts, conflicts / seconds);
+}
+
+/**
+ * propagation_benchmark : (n_propagations : uint64_t) -> [void]
+ * 
+ * Description:
+ *  Microbenchmark of 'propagate'. Assign the variables one by one with 
+ *  pseudo random polarities as decisions and propagate, backtracking to the
+ *  toplevel on conflicts (nothing is learnt), until about n_propagations 
+ *  literals have been propagated. Reports propagations/sec, 
+ *  compare the release build with 'make checked' to see the cost of the 
+ *  checks in the inner loops.
+ */
+void Solver::propagation_benchmark(uint64_t n_propagations) {
+    if (!_myyura || propagate() != CRAREF_UNDEF) {
+        printf("propagation benchmark: unsatisfiable at the toplevel\n");
+        return;
+    }
+
+    uint64_t propagations = _n_propagations;
+    uint32_t seed = 91648253;
+    clock_t start_time = clock();
+
+    for (; _n_propagations - propagations < n_propagations;) {
+        for (Variable x = 0; x < n_variables() && _n_propagations - propagations < n_propagations; x++) {
+            if (value(x) != LIFTED_BOOLEAN_UNDEF) { continue; }
+
+            seed = seed * 1103515245 + 12345;
+            new_decision_level();
+            unchecked_enqueue(Literal(x, (seed >> 16) & 1));
+            if (propagate() != CRAREF_UNDEF) {
+                cancel_until(0);
+            }
+        }
+        cancel_until(0);
+    }
+
+    double seconds = (double)(clock() - start_time) / CLOCKS_PER_SEC;
+    propagations = _n_propagations - propagations;
+    if (seconds <= 0) { seconds = 1e-9; }
+
+    printf("propagation benchmark (%s) | %.3f s | propagations %llu (%.0f/s)\n",
+        CHECKS_ENABLED ? "checked" : "unchecked", seconds, 
+        (unsigned long long)propagations, propagations / seconds);
+}
+
+/**
+ * xor_benchmark : (n_variables : int) (n_xors : int) (seed : uint32_t) -> [void]
+ * 
+ * Description:
+ *  Add a random XOR-SAT problem of 'n_xors' XOR constraints over 3 of 
+ *  'n_variables' new variables each (as 4 clauses) and solve it. Run it on 
+ *  fresh solvers with and without 'gaussian_elimination' to compare.
+ */
+void Solver::xor_benchmark(int n_variables, int n_xors, uint32_t seed) {
+    int first = this->n_variables();
+    for (int i = 0; i < n_variables; i++) { new_variable(); }
+
+    Vector<Literal> ps;
+    for (int i = 0; i < n_xors; i++) {
+        Variable xs[3];
+        for (int k = 0; k < 3; k++) {
+            do {
+                seed = seed * 1103515245 + 12345;
+                xs[k] = first + (seed >> 8) % n_variables;
+            } while ((k > 0 && xs[k] == xs[0]) || (k > 1 && xs[k] == xs[1]));
+        }
+        seed = seed * 1103515245 + 12345;
+        int parity = (seed >> 16) & 1;
+
+        // Each clause forbids one assignment of the other parity
+        for (int s = 0; s < 8; s++) {
+            if (((s ^ (s >> 1) ^ (s >> 2)) & 1) == parity) { continue; }
+            ps.clear();
+            for (int k = 0; k < 3; k++) { ps.push(Literal(xs[k], (s >> k) & 1)); }
+            add_clause(ps);
+        }
+    }
+
+    uint64_t conflicts = _n_conflicts;
+    clock_t start_time = clock();
+    LiftedBoolean status = _solve();
+    double seconds = (double)(clock() - start_time) / CLOCKS_PER_SEC;
+
+    printf("xor %-5s | %d variables, %d xors | %s | %.3f s | conflicts %llu | xor propagations %llu\n",
+        _gauss ? "gauss" : "cnf", n_variables, n_xors,
+        status == LIFTED_BOOLEAN_TRUE ? "SAT  " : (status == LIFTED_BOOLEAN_FALSE ? "UNSAT" : "UNDEF"),
+        seconds, (unsigned long long)(_n_conflicts - conflicts), (unsigned long long)_n_xor_propagations);
+}
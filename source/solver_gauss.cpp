@@ -0,0 +1,541 @@
+/**
+ * The SAT solver
+ * XOR constraints and Gauss-Jordan elimination
+ *
+ * An XOR constraint of k variables is the 2^(k-1) clauses over them with an
+ * even (or an odd) number of negative literals. The ones found in the problem
+ * clauses are kept as bit-packed matrices over GF(2), one per connected
+ * component, in reduced row echelon form. The clauses stay, a matrix only
+ * propagates what they can't see: a row with one unassigned column left
+ * implies its value, a row with none left and the wrong parity is a conflict.
+ *
+ * Every row watches two unassigned columns, its basic column (which is in no
+ * other row) and one more. When the basic variable is assigned the row is
+ * pivoted on another unassigned column: the row is added to every other row
+ * with that column, a word at a time, and the other rows keep their basic
+ * columns. The matrices follow the trail behind the clauses ('xor_head'),
+ * their reasons and conflicts are ordinary clauses made from the row and the
+ * current assignment, so 'analyze' treats them like any other. Most implied
+ * literals never take part in a conflict, so a reason is only made when it
+ * is asked for, from a copy of the row taken at the implication.
+ *
+ * Reference:
+ * [SNC09] M. Soos, K. Nohl, C. Castelluccia. "Extending SAT Solvers to
+ * Cryptographic Problems", SAT 2009
+ * [HJ12] C.S. Han, J.H.R. Jiang. "When Boolean Satisfiability Meets Gaussian
+ * Elimination in a Simplex Way", CAV 2012
+ */
+
+#include "../include/core/solver.hpp"
+#include "../include/util/algorithm.hpp"
+
+using namespace MyyuraSat;
+
+// Private
+
+static inline bool has_column(const uint64_t *bits, int c) {
+    return (bits[c >> 6] >> (c & 63)) & 1;
+}
+
+// The first column of 'row' not in 'assigned', other than 'e1' and 'e2' (-1
+// if there is none)
+static inline int first_unassigned(const uint64_t *row, const uint64_t *assigned, int n_words, int e1, int e2) {
+    for (int k = 0; k < n_words; k++) {
+        uint64_t bits = row[k] & ~assigned[k];
+        if (e1 >= 0 && (e1 >> 6) == k) { bits &= ~((uint64_t)1 << (e1 & 63)); }
+        if (e2 >= 0 && (e2 >> 6) == k) { bits &= ~((uint64_t)1 << (e2 & 63)); }
+        if (bits != 0) { return (k << 6) + __builtin_ctzll(bits); }
+    }
+    return -1;
+}
+
+/**
+ * add_xor_matrix : (vars : const Vector<Variable>&) (begins : const Vector<int>&) (rhs : const Vector<char>&) -> [bool]
+ *
+ * Description:
+ *  Helper of 'extract_xors'. Build the matrix of a connected component of XOR
+ *  constraints, constraint 'i' is 'vars[begins[i]] ^ ... ^
+ *  vars[begins[i + 1] - 1] = rhs[i]'. After Gauss-Jordan elimination the
+ *  rows of a single column are top-level units, the rest stay in the matrix
+ *  (if there are any). Components of more than 'xor_column_limit' variables
+ *  are left to the clauses. Returns false if the constraints are 
+ *  contradictory.
+ */
+bool Solver::add_xor_matrix(const Vector<Variable>& vars, const Vector<int>& begins, const Vector<char>& rhs) {
+    Vector<Variable> columns;
+    for (int i = 0; i < vars.size(); i++) {
+        if (_xor_column[vars[i]] < 0) {
+            _xor_column[vars[i]] = columns.size();
+            columns.push(vars[i]);
+        }
+    }
+
+    if (columns.size() > _xor_column_limit) {
+        for (int i = 0; i < columns.size(); i++) { _xor_column[columns[i]] = -1; }
+        return true;
+    }
+
+    int n_xors = rhs.size();
+    int n_words = (columns.size() + 63) / 64;
+    Vector<uint64_t> rows(n_xors * n_words, 0);
+    Vector<char> values;
+    rhs.copy_to(values);
+    for (int i = 0; i < n_xors; i++) {
+        for (int j = begins[i]; j < begins[i + 1]; j++) {
+            int c = _xor_column[vars[j]];
+            rows[i * n_words + (c >> 6)] ^= (uint64_t)1 << (c & 63);
+        }
+    }
+
+    // Gauss-Jordan elimination, row 'r' gets the basic column 'basic[r]'
+    Vector<int> basic;
+    for (int c = 0; c < columns.size() && basic.size() < n_xors; c++) {
+        int r = basic.size(), p = r;
+        while (p < n_xors && !has_column(&rows[p * n_words], c)) { p++; }
+        if (p == n_xors) { continue; }
+
+        for (int k = 0; k < n_words; k++) { std::swap(rows[r * n_words + k], rows[p * n_words + k]); }
+        std::swap(values[r], values[p]);
+        for (int q = 0; q < n_xors; q++) {
+            if (q != r && has_column(&rows[q * n_words], c)) {
+                for (int k = 0; k < n_words; k++) { rows[q * n_words + k] ^= rows[r * n_words + k]; }
+                values[q] ^= values[r];
+            }
+        }
+        basic.push(c);
+    }
+
+    // The rows left are empty
+    bool ok = true;
+    for (int r = basic.size(); r < n_xors; r++) {
+        if (values[r]) { ok = false; }
+    }
+
+    // Units go to the trail, their columns are in no other row
+    int n_rows = 0;
+    for (int r = 0; r < basic.size() && ok; r++) {
+        int size = 0;
+        for (int k = 0; k < n_words; k++) { size += __builtin_popcountll(rows[r * n_words + k]); }
+
+        if (size == 1) {
+            Variable x = columns[basic[r]];
+            unchecked_enqueue(Literal(x, !values[r]));
+            continue;
+        }
+        for (int k = 0; k < n_words; k++) { rows[n_rows * n_words + k] = rows[r * n_words + k]; }
+        values[n_rows] = values[r];
+        basic[n_rows++] = basic[r];
+    }
+
+    if (!ok || n_rows == 0) {
+        for (int i = 0; i < columns.size(); i++) { _xor_column[columns[i]] = -1; }
+        return ok;
+    }
+
+    _xor_matrices.push();
+    _XorMatrix& m = _xor_matrices.back();
+    m.n_words = n_words;
+    columns.move_to(m.columns);
+    rows.shrink(rows.size() - n_rows * n_words);
+    rows.move_to(m.rows);
+    values.shrink(values.size() - n_rows);
+    values.move_to(m.rhs);
+    basic.shrink(basic.size() - n_rows);
+    basic.move_to(m.basic);
+    m.watch.grow_to(n_rows);
+    m.stamp.grow_to(n_rows, 0);
+    m.watches.grow_to(m.columns.size());
+    m.assigned.grow_to(n_words, 0);
+    m.values.grow_to(n_words, 0);
+
+    for (int r = 0; r < n_rows; r++) {
+        m.watch[r] = first_unassigned(m.row(r), m.assigned, n_words, m.basic[r], -1);
+        m.watches[m.basic[r]].push(r);
+        m.watches[m.watch[r]].push(r);
+    }
+
+    // Eliminating or substituting these would only make the matrix weaker
+    for (int i = 0; i < m.columns.size(); i++) {
+        _xor_matrix[m.columns[i]] = _xor_matrices.size() - 1;
+        _frozen[m.columns[i]] |= 4;
+    }
+
+    return true;
+}
+
+/**
+ * extract_xors : (void) -> [bool]
+ *
+ * Description:
+ *  Find the XOR constraints in the problem clauses and build a matrix for
+ *  each connected component of them (see 'add_xor_matrix'). Runs once, at
+ *  the top level before the first search. Clauses over the same variables
+ *  are found by sorting on a hash of their variables, a set of k variables
+ *  is an XOR constraint if the clauses over it forbid every assignment of
+ *  one parity. Clauses with an assigned or a non-decision variable are not
+ *  used. Returns false if the problem turned out to be unsatisfiable.
+ */
+bool Solver::extract_xors(void) {
+    if (_xor_extracted) { return true; }
+    _xor_extracted = true;
+    // The reasons are not RUP steps in a proof
+    if (!_gauss || _proof != NULL) { return true; }
+
+    Vector<uint64_t> keys;
+    Vector<Variable> xs;
+    for (int i = 0; i < _clauses.size(); i++) {
+        CRARef cr = _clauses[i];
+        const Clause& c = _ca[cr];
+        if (is_removed(cr) || c.size() < 3 || c.size() > _xor_size_limit) { continue; }
+
+        xs.clear();
+        bool skip = false;
+        for (int j = 0; j < c.size() && !skip; j++) {
+            Variable x = c[j].variable();
+            skip = value(x) != LIFTED_BOOLEAN_UNDEF || !_decision[x];
+            xs.push(x);
+        }
+        if (skip) { continue; }
+
+        std::sort(xs.begin(), xs.end());
+        uint32_t hash = c.size();
+        for (int j = 0; j < xs.size(); j++) { hash = (hash ^ xs[j]) * 2654435761u; }
+        keys.push(((uint64_t)hash << 32) | cr);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    // The constraints found, as in 'add_xor_matrix'
+    Vector<Variable> vars;
+    Vector<int> begins;
+    Vector<char> rhs;
+    Vector<Variable> ys;
+    Vector<char> used;
+    for (int i = 0, j; i < keys.size(); i = j) {
+        for (j = i + 1; j < keys.size() && (keys[j] >> 32) == (keys[i] >> 32); j++) {}
+        if (j - i < 4) { continue; }
+
+        // Hash collisions aside, one set of variables
+        used.clear();
+        used.grow_to(j - i, 0);
+        for (int l = i; l < j; l++) {
+            if (used[l - i]) { continue; }
+            const Clause& c = _ca[(CRARef)keys[l]];
+            xs.clear();
+            for (int k = 0; k < c.size(); k++) { xs.push(c[k].variable()); }
+            std::sort(xs.begin(), xs.end());
+
+            // Bit 's' of 'patterns' is set if the assignment 's' (bit 'k' for
+            // 'xs[k]') is forbidden
+            uint64_t patterns = 0;
+            for (int o = l; o < j; o++) {
+                const Clause& d = _ca[(CRARef)keys[o]];
+                if (used[o - i] || d.size() != c.size()) { continue; }
+                ys.clear();
+                for (int k = 0; k < d.size(); k++) { ys.push(d[k].variable()); }
+                std::sort(ys.begin(), ys.end());
+                bool same = true;
+                for (int k = 0; k < xs.size() && same; k++) { same = xs[k] == ys[k]; }
+                if (!same) { continue; }
+
+                used[o - i] = 1;
+                uint32_t s = 0;
+                for (int k = 0; k < d.size(); k++) {
+                    int position = std::lower_bound(xs.begin(), xs.end(), d[k].variable()) - xs.begin();
+                    if (d[k].sign()) { s |= 1u << position; }
+                }
+                patterns |= (uint64_t)1 << s;
+            }
+
+            uint64_t even = 0;
+            for (uint32_t s = 0; s < (1u << xs.size()); s++) {
+                if (__builtin_popcount(s) % 2 == 0) { even |= (uint64_t)1 << s; }
+            }
+            uint64_t odd = (xs.size() == 6 ? ~(uint64_t)0 : ((uint64_t)1 << (1 << xs.size())) - 1) & ~even;
+
+            // Every even assignment forbidden means the parity is odd
+            if ((patterns & even) == even || (patterns & odd) == odd) {
+                for (int k = 0; k < xs.size(); k++) { vars.push(xs[k]); }
+                begins.push(vars.size() - xs.size());
+                rhs.push((patterns & even) == even);
+            }
+        }
+    }
+    begins.push(vars.size());
+    _n_xors += rhs.size();
+
+    // Connected components by union-find over the variables
+    Vector<Variable> parent(n_variables());
+    for (Variable x = 0; x < n_variables(); x++) { parent[x] = x; }
+    auto find = [&](Variable x) -> Variable {
+        while (parent[x] != x) { x = parent[x] = parent[parent[x]]; }
+        return x;
+    };
+    for (int i = 0; i < rhs.size(); i++) {
+        for (int k = begins[i] + 1; k < begins[i + 1]; k++) {
+            Variable x = find(vars[begins[i]]), y = find(vars[k]);
+            if (x != y) { parent[std::max(x, y)] = std::min(x, y); }
+        }
+    }
+    keys.clear();
+    for (int i = 0; i < rhs.size(); i++) {
+        keys.push(((uint64_t)find(vars[begins[i]]) << 32) | (uint32_t)i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    _xor_head = _trail.size();
+    Vector<Variable> component_vars;
+    Vector<int> component_begins;
+    Vector<char> component_rhs;
+    for (int i = 0, j; i < keys.size() && _myyura; i = j) {
+        for (j = i + 1; j < keys.size() && (keys[j] >> 32) == (keys[i] >> 32); j++) {}
+
+        component_vars.clear();
+        component_begins.clear();
+        component_rhs.clear();
+        for (int l = i; l < j; l++) {
+            int x = (uint32_t)keys[l];
+            component_begins.push(component_vars.size());
+            for (int k = begins[x]; k < begins[x + 1]; k++) { component_vars.push(vars[k]); }
+            component_rhs.push(rhs[x]);
+        }
+        component_begins.push(component_vars.size());
+
+        // A single constraint is as good as its clauses
+        if (j - i < 2) { continue; }
+        _myyura = add_xor_matrix(component_vars, component_begins, component_rhs);
+    }
+
+    return _myyura && (_myyura = propagate() == CRAREF_UNDEF);
+}
+
+/**
+ * xor_clause : (m : _XorMatrix&) (row : const uint64_t*) (rhs : int) (implied : int) -> [CRARef]
+ *
+ * Description:
+ *  The clause of a row of 'm' under the current assignment: the literals of
+ *  its assigned columns, all false. With an 'implied' column, its literal
+ *  comes first and is the one the row implies (a reason), otherwise every
+ *  column is assigned and the clause is a conflict.
+ */
+CRARef Solver::xor_clause(_XorMatrix& m, const uint64_t *row, int rhs, int implied) {
+    Vector<Literal>& ps = _xor_literals;
+    ps.clear();
+    if (implied >= 0) { ps.push(); }
+
+    int parity = rhs;
+    for (int k = 0; k < m.n_words; k++) {
+        for (uint64_t bits = row[k]; bits != 0; bits &= bits - 1) {
+            int c = (k << 6) + __builtin_ctzll(bits);
+            if (c == implied) { continue; }
+            Variable x = m.columns[c];
+            bool b = value(x) == LIFTED_BOOLEAN_TRUE;
+            parity ^= b;
+            ps.push(Literal(x, b));
+        }
+    }
+    if (implied >= 0) { ps[0] = Literal(m.columns[implied], parity == 0); }
+
+    return _ca.alloc(ps, false);
+}
+
+/**
+ * xor_reason : (x : Variable) -> [CRARef]
+ *
+ * Description:
+ *  Make the reason of 'x', implied by a matrix with 'CRAREF_LAZY', from the
+ *  row it was implied by. The other columns of the row were assigned before
+ *  it and still are.
+ */
+CRARef Solver::xor_reason(Variable x) {
+    _XorImplied& e = _xor_implied[_xor_implied_index[x]];
+    _XorMatrix& m = _xor_matrices[_xor_matrix[x]];
+    const uint64_t *row = &_xor_row_copies[e.row];
+    e.reason = xor_clause(m, row, e.rhs, _xor_column[x]);
+    return _variable_info[x].reason = e.reason;
+}
+
+/**
+ * xor_pivot : (m : _XorMatrix&) (r : int) (y : int) (c : int) -> [void]
+ *
+ * Description:
+ *  Make the unassigned column 'y' the basic column of row 'r', whose basic
+ *  column 'c' was just assigned: the row is added to every other row with
+ *  column 'y', which then get new watches if theirs were cancelled.
+ */
+void Solver::xor_pivot(_XorMatrix& m, int r, int y, int c) {
+    const uint64_t *pivot = m.row(r);
+    int word = y >> 6;
+    uint64_t mask = (uint64_t)1 << (y & 63);
+
+    Vector<int>& pivoted = _xor_pivoted;
+    pivoted.clear();
+    for (int q = 0; q < m.n_rows(); q++) {
+        uint64_t *row = m.row(q);
+        if (q == r || (row[word] & mask) == 0) { continue; }
+        for (int k = 0; k < m.n_words; k++) { row[k] ^= pivot[k]; }
+        m.rhs[q] ^= m.rhs[r];
+        pivoted.push(q);
+    }
+    m.basic[r] = y;
+    m.watches[y].push(r);
+
+    // Their basic columns are unassigned, so this pivots no further. All of
+    // them have 'c' now.
+    for (int i = 0; i < pivoted.size(); i++) {
+        int q = pivoted[i];
+        if (!has_column(m.row(q), m.watch[q]) || has_column(m.assigned, m.watch[q])) {
+            xor_update_row(m, q, c);
+        }
+    }
+}
+
+/**
+ * xor_update_row : (m : _XorMatrix&) (r : int) (c : int) -> [CRARef]
+ *
+ * Description:
+ *  Restore the watches of row 'r' after one of them was assigned (or left
+ *  the row) with the assignment of column 'c'. The row is pivoted if its 
+ *  basic column was assigned. If a single unassigned column is left, it is
+ *  the basic one and its value is implied, the other watch goes to 'c', the
+ *  column assigned last, which is unassigned first when backtracking. 
+ *  Returns the conflict if none is left and the parity is wrong.
+ */
+CRARef Solver::xor_update_row(_XorMatrix& m, int r, int c) {
+    uint64_t *row = m.row(r);
+    int b = m.basic[r], w = m.watch[r];
+
+    if (has_column(m.assigned, b)) {
+        int y = first_unassigned(row, m.assigned, m.n_words, b, w);
+        if (y < 0 && has_column(row, w) && !has_column(m.assigned, w)) { y = w; }
+
+        if (y < 0) {
+            int parity = m.rhs[r];
+            for (int k = 0; k < m.n_words; k++) { parity ^= __builtin_popcountll(row[k] & m.values[k]) & 1; }
+            if (parity == 0) { return CRAREF_UNDEF; }
+
+            _n_xor_conflicts++;
+            return _xor_conflict = xor_clause(m, row, m.rhs[r], -1);
+        }
+        xor_pivot(m, r, y, c);
+        b = y;
+    }
+
+    if (w != b && has_column(row, w) && !has_column(m.assigned, w)) { return CRAREF_UNDEF; }
+
+    int y = first_unassigned(row, m.assigned, m.n_words, b, -1);
+    if (y >= 0) {
+        m.watch[r] = y;
+        m.watches[y].push(r);
+        return CRAREF_UNDEF;
+    }
+
+    if (CHECKS_ENABLED && !has_column(row, c)) {
+        throw std::logic_error("Solver::xor_update_row : the assigned column is not in the row");
+    }
+    if (w != c) {
+        m.watch[r] = c;
+        m.watches[c].push(r);
+    }
+
+    // An assigned basic variable is checked when the matrix gets to it. The
+    // top level needs no reasons
+    Variable x = m.columns[b];
+    if (value(x) != LIFTED_BOOLEAN_UNDEF) { return CRAREF_UNDEF; }
+
+    int parity = m.rhs[r];
+    for (int k = 0; k < m.n_words; k++) { parity ^= __builtin_popcountll(row[k] & m.values[k]) & 1; }
+    if (decision_level() == 0) {
+        unchecked_enqueue(Literal(x, parity == 0));
+    } else {
+        _xor_implied_index[x] = _xor_implied.size();
+        _xor_implied.push(_XorImplied(x, _xor_row_copies.size(), m.rhs[r]));
+        for (int k = 0; k < m.n_words; k++) { _xor_row_copies.push(row[k]); }
+        unchecked_enqueue(Literal(x, parity == 0), CRAREF_LAZY);
+    }
+    _n_xor_propagations++;
+    return CRAREF_UNDEF;
+}
+
+/**
+ * propagate_xors : (void) -> [CRARef]
+ *
+ * Description:
+ *  Assign the variables on the trail from 'xor_head' in their matrices and
+ *  update the rows watching them, see 'xor_update_row'. The implied literals
+ *  are enqueued (and assigned in the matrices in turn). Returns the conflict
+ *  clause, if any.
+ */
+CRARef Solver::propagate_xors(void) {
+    for (; _xor_head < _trail.size(); _xor_head++) {
+        Literal p = _trail[_xor_head];
+        Variable x = p.variable();
+        if (_xor_matrix[x] < 0) { continue; }
+
+        _XorMatrix& m = _xor_matrices[_xor_matrix[x]];
+        int c = _xor_column[x];
+        m.assigned[c >> 6] |= (uint64_t)1 << (c & 63);
+        if (!p.sign()) { m.values[c >> 6] |= (uint64_t)1 << (c & 63); }
+
+        // The rows that still watch 'c' are put back, stale and repeated
+        // entries are dropped
+        Vector<int>& rows = _xor_rows;
+        m.watches[c].copy_to(rows);
+        m.watches[c].clear();
+        _xor_stamp++;
+
+        CRARef conflict = CRAREF_UNDEF;
+        int i = 0;
+        for (; i < rows.size() && conflict == CRAREF_UNDEF; i++) {
+            int r = rows[i];
+            if (m.stamp[r] == _xor_stamp || (m.basic[r] != c && m.watch[r] != c)) { continue; }
+            m.stamp[r] = _xor_stamp;
+
+            conflict = xor_update_row(m, r, c);
+            if ((m.basic[r] == c || m.watch[r] == c) && (m.watches[c].size() == 0 || m.watches[c].back() != r)) {
+                m.watches[c].push(r);
+            }
+        }
+
+        if (conflict != CRAREF_UNDEF) {
+            for (; i < rows.size(); i++) { m.watches[c].push(rows[i]); }
+            _xor_head++;
+            return conflict;
+        }
+    }
+
+    return CRAREF_UNDEF;
+}
+
+/**
+ * cancel_xors : (level : int) -> [void]
+ *
+ * Description:
+ *  Part of 'cancel_until', before the trail is cut back to 'level': unassign
+ *  the variables in their matrices and free the reasons and the conflict
+ *  made by the matrices (and the copies of the rows).
+ */
+void Solver::cancel_xors(int level) {
+    for (int i = _xor_head - 1; i >= _trail_lim[level]; i--) {
+        Literal p = _trail[i];
+        Variable x = p.variable();
+        if (_xor_matrix[x] < 0) { continue; }
+
+        _XorMatrix& m = _xor_matrices[_xor_matrix[x]];
+        int c = _xor_column[x];
+        m.assigned[c >> 6] &= ~((uint64_t)1 << (c & 63));
+        m.values[c >> 6] &= ~((uint64_t)1 << (c & 63));
+    }
+    _xor_head = std::min(_xor_head, _trail_lim[level]);
+
+    while (_xor_implied.size() > 0 && _variable_info[_xor_implied.back().x].level > level) {
+        const _XorImplied& e = _xor_implied.back();
+        if (e.reason != CRAREF_UNDEF) { _ca.free(e.reason); }
+        _xor_row_copies.shrink(_xor_row_copies.size() - e.row);
+        _xor_implied.pop();
+    }
+
+    if (_xor_conflict != CRAREF_UNDEF) {
+        _ca.free(_xor_conflict);
+        _xor_conflict = CRAREF_UNDEF;
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * The SAT solver
+ * Proof output
+ *
+ * Every clause the solver adds (learnt clauses, shortened or strengthened
+ * clauses, top-level units) is written to the proof, and every clause it
+ * removes is deleted from it. For LRAT, each added clause also lists its
+ * antecedents: the ids of the clauses that, in this order, propagate to a
+ * conflict under the negation of the added clause.
+ */
+
+#include "../include/core/solver.hpp"
+
+using namespace MyyuraSat;
+
+// Private ********************************************************************
+
+inline bool Solver::lrat(void) const {
+    return _proof != NULL && _proof->lrat();
+}
+
+// Id for a clause derived by the solver, after the ids of the problem clauses
+inline uint64_t Solver::new_clause_id(void) {
+    if (_problem_ids_end < _next_problem_id) { _problem_ids_end = _next_problem_id; }
+    if (_next_clause_id < _problem_ids_end) { _next_clause_id = _problem_ids_end; }
+    return _next_clause_id++;
+}
+
+// Add a clause with the antecedents in '_proof_hints' (LRAT)
+inline void Solver::proof_add(const Literal *lits, int n, uint64_t id) {
+    _proof->add(lits, n, id, _proof_hints);
+}
+
+inline void Solver::proof_remove(const Clause& c) {
+    _proof->remove((const Literal*)c, c.size(), c.has_id() ? c.id() : 0);
+}
+
+/**
+ * proof_units : (void) -> [void]
+ *
+ * Description:
+ *  Give every top-level assignment a unit clause in the proof. A unit implied
+ *  by a reason clause is derived from the reason and the units of the other
+ *  literals of the reason (LRAT), which are all earlier on the trail. Called
+ *  before a reason is deleted, and for LRAT whenever the top level grows.
+ */
+void Solver::proof_units(void) {
+    int end = decision_level() == 0 ? _trail.size() : _trail_lim[0];
+
+    for (; _proof_units_head < end; _proof_units_head++) {
+        Literal p = _trail[_proof_units_head];
+        CRARef r = reason(p.variable());
+        if (_unit_id[p.variable()] != 0 || r == CRAREF_UNDEF) { continue; }
+
+        _proof_hints.clear();
+        if (lrat()) {
+            const Clause& c = _ca[r];
+            for (int i = 0; i < c.size(); i++) {
+                if (c[i] != p) { _proof_hints.push(_unit_id[c[i].variable()]); }
+            }
+            _proof_hints.push(c.id());
+        }
+
+        uint64_t id = new_clause_id();
+        proof_add(&p, 1, id);
+        _unit_id[p.variable()] = id;
+    }
+}
+
+/**
+ * proof_chain : (conflict : Clause*) (learnt : const Vector<Literal>&) -> [void]
+ *
+ * Description:
+ *  Collect the antecedents of a learnt clause into '_proof_hints' (LRAT), must
+ *  be called before backtracking. Starting from the conflict clause, every
+ *  literal that is not in the learnt clause is explained by its reason,
+ *  walking the trail backwards. This covers the literals resolved away by
+ *  'analyze' as well as the ones removed by the minimization. The reasons are
+ *  listed in trail order after the top-level units, the conflict comes last.
+ */
+void Solver::proof_chain(CRARef conflict, const Vector<Literal>& learnt) {
+    // '_seen': 1 - still to be explained, 2 - in the learnt clause or done
+    _analyze_toclear.clear();
+    for (int i = 0; i < learnt.size(); i++) {
+        _seen[learnt[i].variable()] = 2;
+        _analyze_toclear.push(learnt[i]);
+    }
+
+    _proof_hints.clear();
+    _proof_chain.clear();
+    _proof_chain.push(_ca[conflict].id());
+    int pending = 0;
+    Variable x = VARIABLE_UNDEF;
+
+    for (int index = _trail.size() - 1; ; index--) {
+        const Clause& c = _ca[conflict];
+        for (int i = 0; i < c.size(); i++) {
+            Variable y = c[i].variable();
+            if (y == x || _seen[y]) { continue; }
+
+            _analyze_toclear.push(c[i]);
+            if (level(y) == 0) {
+                _seen[y] = 2;
+                _proof_hints.push(_unit_id[y]);
+            } else {
+                _seen[y] = 1;
+                pending++;
+            }
+        }
+
+        if (pending == 0) { break; }
+
+        for (; _seen[_trail[index].variable()] != 1; index--) {}
+        x = _trail[index].variable();
+        _seen[x] = 2;
+        pending--;
+
+        conflict = reason(x);
+        if (CHECKS_ENABLED && conflict == CRAREF_UNDEF) {
+            throw std::logic_error("Solver::proof_chain : a decision is not in the learnt clause");
+        }
+        _proof_chain.push(_ca[conflict].id());
+    }
+
+    for (int i = _proof_chain.size() - 1; i >= 0; i--) {
+        _proof_hints.push(_proof_chain[i]);
+    }
+
+    for (int i = 0; i < _analyze_toclear.size(); i++) {
+        _seen[_analyze_toclear[i].variable()] = 0;
+    }
+}
+
+/**
+ * proof_empty_clause : (conflict : Clause*) -> [void]
+ *
+ * Description:
+ *  Add the empty clause, 'conflict' is falsified at the top level.
+ */
+void Solver::proof_empty_clause(CRARef conflict) {
+    _proof_hints.clear();
+
+    if (lrat()) {
+        proof_units();
+
+        const Clause& c = _ca[conflict];
+        _proof_hints.clear();
+        for (int i = 0; i < c.size(); i++) {
+            _proof_hints.push(_unit_id[c[i].variable()]);
+        }
+        _proof_hints.push(c.id());
+    }
+
+    proof_add(NULL, 0, new_clause_id());
+}
+
+/**
+ * proof_strengthen : (cr : Clause*) (p : Literal) (by : uint64_t) -> [void]
+ *
+ * Description:
+ *  The literal 'p' is about to be removed from clause 'cr' by self-subsuming
+ *  resolution with the clause (or top-level unit) of id 'by'. Add the 
+ *  strengthened clause and delete the old one, the clause gets a new id.
+ */
+void Solver::proof_strengthen(CRARef cr, Literal p, uint64_t by) {
+    Clause& c = _ca[cr];
+
+    _proof_literals.clear();
+    for (int i = 0; i < c.size(); i++) {
+        if (c[i] != p) { _proof_literals.push(c[i]); }
+    }
+
+    _proof_hints.clear();
+    if (lrat()) {
+        _proof_hints.push(by);
+        _proof_hints.push(c.id());
+    }
+
+    uint64_t id = new_clause_id();
+    proof_add(_proof_literals, _proof_literals.size(), id);
+    proof_remove(c);
+    if (c.has_id()) { c.id(id); }
+}
+
+// Public *********************************************************************
+
+inline void Solver::proof(FILE *out, ProofFormat format) {
+    if (_next_problem_id != 1) {
+        throw std::logic_error("Solver::proof : clauses were added before");
+    }
+
+    delete _proof;
+    _proof = new Proof(out, format);
+    _ca.clause_ids(_proof->lrat());
+}
+
+inline void Solver::proof_problem_clauses(int n) {
+    if (_problem_ids_end < _next_problem_id + n) { _problem_ids_end = _next_problem_id + n; }
+}
@@ -6,6 +6,8 @@
 #include "../include/core/solver.hpp"
 #include "../include/util/algorithm.hpp"
 
+#include <cmath>
+
 using namespace MyyuraSat;
 
 // Private methods
@@ -14,10 +16,27 @@ inline CRARef Solver::reason(Variable x) const {
     return _variable_info[x].reason;
 }
 
+inline CRARef Solver::reason_clause(Variable x) {
+    CRARef cr = _variable_info[x].reason;
+    return cr == CRAREF_LAZY ? xor_reason(x) : cr;
+}
+
 inline int Solver::level(Variable x) const {
     return _variable_info[x].level;
 }
 
+inline bool Solver::is_true(Literal p) const {
+    return _values[p] > 0;
+}
+
+inline bool Solver::is_false(Literal p) const {
+    return _values[p] < 0;
+}
+
+inline uint32_t Solver::abstract_level(Variable x) const {
+    return 1 << (level(x) & 31);
+}
+
 inline bool Solver::enqueue(Literal p, CRARef from) {
     return value(p) != LIFTED_BOOLEAN_UNDEF ? 
         value(p) != LIFTED_BOOLEAN_FALSE : (unchecked_enqueue(p, from), true);
@@ -31,12 +50,92 @@ inline int Solver::decision_level(void) const {
     return _trail_lim.size();
 }
 
+inline void Solver::insert_variable_order(Variable x) {
+    if (!_order_heap.in_heap(x) && _decision[x]) {
+        _order_heap.insert(x);
+    }
+}
+
+inline void Solver::variable_bump_activity(Variable x) {
+    if ((_activity[x] += _variable_inc) > 1e100) {
+        // Rescale:
+        for (Variable i = 0; i < n_variables(); i++) {
+            _activity[i] *= 1e-100;
+        }
+        _variable_inc *= 1e-100;
+    }
+
+    // Update order_heap with respect to new activity:
+    if (_order_heap.in_heap(x)) {
+        _order_heap.decrease(x);
+    }
+}
+
+inline void Solver::variable_decay_activity(void) {
+    _variable_inc *= (1 / _variable_decay);
+}
+
+inline void Solver::clause_bump_activity(Clause& c) {
+    if ((c.activity() += _clause_inc) > 1e20) {
+        // Rescale:
+        for (int i = 0; i < _learnts.size(); i++) {
+            _ca[_learnts[i]].activity() *= 1e-20;
+        }
+        _clause_inc *= 1e-20;
+    }
+}
+
+inline void Solver::clause_decay_activity(void) {
+    _clause_inc *= (1 / _clause_decay);
+}
+
+inline void Solver::variable_bump(Variable x) {
+    if (_branch_heuristic == BRANCH_VMTF) {
+        _vmtf_bumped.push(x);
+    } else {
+        variable_bump_activity(x);
+    }
+}
+
+// Append 'x' to the end of the queue
+inline void Solver::vmtf_enqueue(Variable x) {
+    _VmtfLink& l = _vmtf_links[x];
+    l.prev = _vmtf_last;
+    l.next = VARIABLE_UNDEF;
+    l.stamp = ++_vmtf_stamp;
+
+    if (_vmtf_last == VARIABLE_UNDEF) {
+        _vmtf_first = x;
+    } else {
+        _vmtf_links[_vmtf_last].next = x;
+    }
+    _vmtf_last = x;
+}
+
+inline void Solver::vmtf_dequeue(Variable x) {
+    _VmtfLink& l = _vmtf_links[x];
+
+    if (l.prev == VARIABLE_UNDEF) {
+        _vmtf_first = l.next;
+    } else {
+        _vmtf_links[l.prev].next = l.next;
+    }
+
+    if (l.next == VARIABLE_UNDEF) {
+        _vmtf_last = l.prev;
+    } else {
+        _vmtf_links[l.next].prev = l.prev;
+    }
+}
+
 // major methods
 void Solver::attach_clause_watcher(CRARef cr) {
     const Clause& c = _ca[cr];
 
-    _watches[~c[0]].push(_Watcher(cr, c[1]));
-    _watches[~c[1]].push(_Watcher(cr, c[0]));
+    bool binary = c.size() == 2;
+
+    _watches[~c[0]].push(_Watcher(cr, c[1], binary));
+    _watches[~c[1]].push(_Watcher(cr, c[0], binary));
 
     // for (int i = 0; i < c.size(); i++) {
     //     _watches[~c[i]].push(_Watcher(cr));
@@ -59,9 +158,9 @@ void Solver::detach_clause_watcher(CRARef cr, bool strict) {
 LiftedBoolean Solver::is_satisfied(const Clause& c) const {
     LiftedBoolean result = LIFTED_BOOLEAN_FALSE;
     for (int i = 0; i < c.size(); i++) {
-        if (value(c[i]) == LIFTED_BOOLEAN_TRUE) {
+        if (is_true(c[i])) {
             return LIFTED_BOOLEAN_TRUE;
-        } else if (value(c[i]) == LIFTED_BOOLEAN_UNDEF) {
+        } else if (!is_false(c[i])) {
             result = LIFTED_BOOLEAN_UNDEF;
         }
     }
@@ -74,11 +173,13 @@ void Solver::unchecked_enqueue(Literal p, CRARef from) {
     //     printf("decision level:%d | %d:%d\n", decision_level(), i, value(i).to_int());
     // }
     // printf("enqueue %d %d:%d %d\n", p.to_int(), p.variable(), value(p).to_int(), value(p.variable()).to_int()); 
-    if (value(p) != LIFTED_BOOLEAN_UNDEF) {
+    if (CHECKS_ENABLED && value(p) != LIFTED_BOOLEAN_UNDEF) {
         throw std::logic_error("Solver::unchecked_enqueue : p has already get an assignment!");
     }
 
     _assigns[p.variable()] = LiftedBoolean(!p.sign());
+    _values[p] = 1;
+    _values[~p] = -1;
     _variable_info[p.variable()] = _VariableInfo(from, decision_level());
     _trail.push_lazy(p);
 }
@@ -86,10 +187,21 @@ void Solver::unchecked_enqueue(Literal p, CRARef from) {
 // Revert to the state at given level (keeping all assignment at 'level' but not beyond).
 void Solver::cancel_until(int level) {
     if (decision_level() > level) {
+        if (_xor_matrices.size() > 0) { cancel_xors(level); }
         for (int c = _trail.size() - 1; c >= _trail_lim[level]; c--) {
             Variable x = _trail[c].variable();
             _assigns[x] = LIFTED_BOOLEAN_UNDEF;
-            _polarity[x] = false;
+            _values[_trail[c]] = 0;
+            _values[~_trail[c]] = 0;
+            // Phase saving, the next decision on 'x' repeats this value
+            _polarity[x] = !_trail[c].sign();
+            if (_branch_heuristic == BRANCH_VMTF) {
+                if (_vmtf_links[x].stamp > _vmtf_links[_vmtf_search].stamp) {
+                    _vmtf_search = x;
+                }
+            } else {
+                insert_variable_order(x);
+            }
         }
         _queue_head = _trail_lim[level];
         _trail.shrink(_trail.size() - _trail_lim[level]);
@@ -109,24 +221,51 @@ void Solver::cancel_until(int level) {
  * Conference, 2001
  */
 CRARef Solver::propagate() {
-    std::cout << "propagate begin! =================" << std::endl;
+    _trace.log(TRACE_PROPAGATE, 2, "propagate begin: level %d, queue %d/%d", 
+        decision_level(), _queue_head, _trail.size());
     CRARef conflict = CRAREF_UNDEF;
 
-    for (; _queue_head < _trail.size();) {
+    for (;;) {
+        // Then the XOR constraints, until both are done
+        if (_queue_head == _trail.size()) {
+            if (conflict != CRAREF_UNDEF || _xor_matrices.size() == 0 || _xor_head == _trail.size()) { break; }
+            if ((conflict = propagate_xors()) != CRAREF_UNDEF) { break; }
+            continue;
+        }
+
         // 'p' is enqueued fact to propagate
         Literal p = _trail[_queue_head++];
+        _n_propagations++;
         Vector<_Watcher>& ws = _watches.lookup(p);
         Vector<_Watcher>::Iterator i, j;
 
         for (i = j = ws.begin(); i != ws.end();) {
             // Try to avoid inspecting the clause:
             Literal blocker = (*i).blocker;
-            if (value(blocker) == LIFTED_BOOLEAN_TRUE) {
+            if (is_true(blocker)) {
                 *j++ = *i++;
                 continue;
             }
 
             CRARef cr = (*i).cref;
+
+            // Binary clause -- the blocker is the other literal:
+            if ((*i).binary) {
+                *j++ = *i++;
+                if (is_false(blocker)) {
+                    conflict = cr;
+                    _queue_head = _trail.size();
+                    // Copy the remaining watches:
+                    while (i != ws.end()) {
+                        *j++ = *i++;
+                    }
+                } else {
+                    unchecked_enqueue(blocker, cr);
+                }
+                continue;
+            }
+
+
             // std::cout << "cr: " << cr << " | size: " << _ca.size() << std::endl;
             Clause& c = _ca[cr];
 
@@ -141,7 +280,7 @@ CRARef Solver::propagate() {
             // If 0th watch is true, then clause is already satisfied.
             Literal first = c[0];
             _Watcher w(cr, first);
-            if (first != blocker && value(first) == LIFTED_BOOLEAN_TRUE) {
+            if (first != blocker && is_true(first)) {
                 *j++ = w; 
                 continue; 
             }
@@ -149,7 +288,7 @@ CRARef Solver::propagate() {
             // Look for new watch:
             bool found_watch = false;
             for (int k = 2; k < c.size(); k++) {
-                if (value(c[k]) != LIFTED_BOOLEAN_FALSE) {
+                if (!is_false(c[k])) {
                     c[1] = c[k];
                     c[k] = false_lit;
                     _watches[~c[1]].push(w);
@@ -161,7 +300,7 @@ CRARef Solver::propagate() {
             if (!found_watch) {
                 // Did not find watch -- clause is unit under assignment:
                 *j++ = w;
-                if (value(first) == LIFTED_BOOLEAN_FALSE){
+                if (is_false(first)) {
                     conflict = cr;
                     _queue_head = _trail.size();
                     // Copy the remaining watches:
@@ -176,7 +315,7 @@ CRARef Solver::propagate() {
 
         ws.shrink(i - j);
     }
-    std::cout << "propagate end! =================" << std::endl;
+    _trace.log(TRACE_PROPAGATE, 2, "propagate end: conflict %u", conflict);
     return conflict;
 }
 
@@ -194,7 +333,7 @@ void Solver::analyze(CRARef conflict, Vector<Literal>& out_learnt, int& out_leve
     if (conflict == CRAREF_UNDEF) {
         throw std::logic_error("No conflict clause needs to be analyzed!");
     }
-    std::cout << "analyze begin=============" << std::endl;
+    _trace.log(TRACE_ANALYZE, 1, "analyze begin: conflict %u at level %d", conflict, decision_level());
     // Generate conflict clause:
     int path_conflict = 0;
     Literal p = LITERAL_UNDEF;
@@ -204,17 +343,36 @@ void Solver::analyze(CRARef conflict, Vector<Literal>& out_learnt, int& out_leve
     int index = _trail.size() - 1;
 
     do {
-        std::cout << path_conflict << std::endl;
+        _trace.log(TRACE_ANALYZE, 3, "analyze: %d literals left at the conflict level", path_conflict);
         if (conflict == CRAREF_UNDEF) {
             throw std::logic_error("Solver::analyze : no conflict to analyze!");
         }
         
         Clause& c = _ca[conflict];
 
+        // Binary clauses are not reordered by 'propagate', the implied literal
+        // has to be moved to the front here:
+        if (p != LITERAL_UNDEF && c.size() == 2 && c[0] != p) {
+            c[1] = c[0];
+            c[0] = p;
+        }
+
+        if (c.learnt()) {
+            clause_bump_activity(c);
+
+            // Clauses taking part in conflicts may deserve a better tier:
+            if (c.lbd() > _core_lbd) {
+                uint32_t lbd = compute_lbd(c);
+                if (lbd + 1 < c.lbd()) { c.lbd(lbd); }
+                c.used(true);
+            }
+        }
+
         for (int j = (p == LITERAL_UNDEF) ? 0 : 1; j < c.size(); j++){
             Literal q = c[j];
 
             if (!_seen[q.variable()] && level(q.variable()) > 0){
+                variable_bump(q.variable());
                 _seen[q.variable()] = 1;
                 if (level(q.variable()) >= decision_level())
                     path_conflict++;
@@ -226,13 +384,34 @@ void Solver::analyze(CRARef conflict, Vector<Literal>& out_learnt, int& out_leve
         // Select next clause to look at:
         while (!_seen[_trail[index--].variable()]);
         p = _trail[index + 1];
-        conflict = reason(p.variable());
+        conflict = reason_clause(p.variable());
         _seen[p.variable()] = 0;
         path_conflict--;
 
     } while (path_conflict > 0);
     out_learnt[0] = ~p;
 
+    // Simplify conflict clause (recursive minimization):
+    int i, j;
+    out_learnt.copy_to(_analyze_toclear);
+
+    // (maintain an abstraction of levels involved in conflict)
+    uint32_t abstract_levels = 0;
+    for (i = 1; i < out_learnt.size(); i++) {
+        abstract_levels |= abstract_level(out_learnt[i].variable());
+    }
+
+    for (i = j = 1; i < out_learnt.size(); i++) {
+        if (reason(out_learnt[i].variable()) == CRAREF_UNDEF || 
+            !literal_redundant(out_learnt[i], abstract_levels)) {
+            out_learnt[j++] = out_learnt[i];
+        }
+    }
+
+    _n_max_literals += out_learnt.size();
+    out_learnt.shrink(i - j);
+    _n_total_literals += out_learnt.size();
+
     // Find correct backtrack level:
     if (out_learnt.size() == 1) {
         out_level = 0;
@@ -252,57 +431,322 @@ void Solver::analyze(CRARef conflict, Vector<Literal>& out_learnt, int& out_leve
         out_level = level(p.variable());
     }
 
-    // Clear _seen
-    for (Variable i = 0; i < n_variables(); i++) {
-        _seen[i] = 0;
+    if (_branch_heuristic == BRANCH_VMTF) {
+        vmtf_bump_queue();
     }
 
-    std::cout << "analyze end==========================" << std::endl;
+    // Clear '_seen', only the entries touched by this analysis
+    for (int j = 0; j < _analyze_toclear.size(); j++) {
+        _seen[_analyze_toclear[j].variable()] = 0;
+    }
+
+    _trace.log(TRACE_ANALYZE, 1, "analyze end: learnt size %d, backtrack to %d", out_learnt.size(), out_level);
 }
 
 /**
- * Branch on literals
+ * literal_redundant : (p : Literal) (abstract_levels : uint32_t) -> [bool]
+ * 
+ * Description:
+ *  Check if 'p' can be removed from a conflict clause, i.e. every path from 
+ *  'p' back to the decisions in the implication graph ends in a literal that 
+ *  is already in the clause. 'abstract_levels' is used to abort early if the
+ *  algorithm is visiting literals at levels that cannot be removed later.
  * 
  * Reference:
+ * [SB09] N. Sörensson, A. Biere. "Minimizing Learned Clauses", Proc. of SAT, 
+ * 2009
+ */
+bool Solver::literal_redundant(Literal p, uint32_t abstract_levels) {
+    _analyze_stack.clear();
+    _analyze_stack.push(p);
+    int top = _analyze_toclear.size();
+
+    for (; _analyze_stack.size() > 0;) {
+        Clause& c = _ca[reason_clause(_analyze_stack.back().variable())];
+        _analyze_stack.pop();
+
+        // (the implied literal of a binary reason may be second)
+        if (c.size() == 2 && is_false(c[0])) {
+            Literal q = c[0];
+            c[0] = c[1];
+            c[1] = q;
+        }
+
+        for (int i = 1; i < c.size(); i++) {
+            Literal q = c[i];
+            if (!_seen[q.variable()] && level(q.variable()) > 0) {
+                if (reason(q.variable()) != CRAREF_UNDEF && 
+                    (abstract_level(q.variable()) & abstract_levels) != 0) {
+                    _seen[q.variable()] = 1;
+                    _analyze_stack.push(q);
+                    _analyze_toclear.push(q);
+                } else {
+                    for (int j = top; j < _analyze_toclear.size(); j++) {
+                        _seen[_analyze_toclear[j].variable()] = 0;
+                    }
+                    _analyze_toclear.shrink(_analyze_toclear.size() - top);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * analyze_final : (p : Literal) (out_conflict : LSet&) -> [void]
  * 
- * TODO:
+ * Description:
+ *  Specialized analysis procedure to express the final conflict in terms of 
+ *  assumptions. Calculates the (possibly empty) set of assumptions that led 
+ *  to the assignment of 'p', and stores the result in 'out_conflict'.
+ */
+void Solver::analyze_final(Literal p, LSet& out_conflict) {
+    out_conflict.clear();
+    out_conflict.insert(p);
+
+    if (decision_level() == 0) { return; }
+
+    _seen[p.variable()] = 1;
+
+    for (int i = _trail.size() - 1; i >= _trail_lim[0]; i--) {
+        Variable x = _trail[i].variable();
+        if (!_seen[x]) { continue; }
+
+        if (reason(x) == CRAREF_UNDEF) {
+            // Only assumptions are decided before the conflict
+            out_conflict.insert(~_trail[i]);
+        } else {
+            const Clause& c = _ca[reason_clause(x)];
+            for (int j = 0; j < c.size(); j++) {
+                if (c[j].variable() != x && level(c[j].variable()) > 0) {
+                    _seen[c[j].variable()] = 1;
+                }
+            }
+        }
+        _seen[x] = 0;
+    }
+
+    _seen[p.variable()] = 0;
+}
+
+/**
+ * Branch on literals
+ * 
+ * Description:
+ *  Pick the unassigned decision variable with the highest activity. Assigned
+ *  variables are removed from the heap lazily here, and are inserted again by
+ *  'cancel_until' when they become unassigned.
+ * 
+ * Reference:
  * [MZ01] M.W.Moskewicz, C.F. Madigan, Y. Zhao, L. Zhang, S. Malik. "Chaff: 
  * Engineering an Efficient SAT Solver", Proc. of the 38th Design Automation
  * Conference, 2001
  */
 Literal Solver::pick_branch_literal(void) {
+    if (_branch_heuristic == BRANCH_OCCURENCE) {
+        return pick_branch_literal_occurence();
+    }
+
     Variable v = VARIABLE_UNDEF;
-    int max_activity = 0;
-
-    for (Variable i = 0; i < n_variables(); i++) {
-        if (value(i) != LIFTED_BOOLEAN_UNDEF) { continue; }
-
-        int activity = 0;
-        for (int j = 0; j < _clauses.size(); j++) {
-            Clause& c = _ca[_clauses[j]];
-            if (c.mark()) { continue; }
-            
-            for (int k = 0; k < c.size(); k++) {
-                if (c[k].variable() == i) { 
-                    activity++; 
-                    break;
-                }
+
+    if (_branch_heuristic == BRANCH_VMTF) {
+        // Walk towards the front of the queue from the cached search pointer:
+        for (v = _vmtf_search; v != VARIABLE_UNDEF; v = _vmtf_links[v].prev) {
+            if (value(v) == LIFTED_BOOLEAN_UNDEF && _decision[v]) { break; }
+        }
+
+        if (v == VARIABLE_UNDEF) {
+            return LITERAL_UNDEF;
+        }
+        _vmtf_search = v;
+    } else {
+        // Activity based decision:
+        for (; v == VARIABLE_UNDEF || value(v) != LIFTED_BOOLEAN_UNDEF || !_decision[v];) {
+            if (_order_heap.empty()) {
+                return LITERAL_UNDEF;
             }
+
+            v = _order_heap.remove_min();
+        }
+    }
+
+    return _polarity[v] ? Literal(v) : ~Literal(v);
+}
+
+/**
+ * vmtf_bump_queue : (void) -> [void]
+ * 
+ * Description:
+ *  Move the variables seen in the last conflict analysis to the end of the 
+ *  VMTF queue. They are bumped in the order of their old stamps, so that their 
+ *  relative order in the queue is kept.
+ * 
+ * Reference:
+ * [BF15] A. Biere, A. Fröhlich. "Evaluating CDCL Variable Scoring Schemes", 
+ * Proc. of SAT, 2015
+ */
+void Solver::vmtf_bump_queue(void) {
+    const VMap<_VmtfLink>& links = _vmtf_links;
+    std::sort(_vmtf_bumped.begin(), _vmtf_bumped.end(), [&](Variable x, Variable y) -> bool {
+        return links[x].stamp < links[y].stamp;
+    });
+
+    for (int i = 0; i < _vmtf_bumped.size(); i++) {
+        Variable x = _vmtf_bumped[i];
+        if (x != _vmtf_last) {
+            vmtf_dequeue(x);
+            vmtf_enqueue(x);
         }
-        if (activity > max_activity) {
-            v = i;
-            max_activity = activity;
+
+        if (value(x) == LIFTED_BOOLEAN_UNDEF) {
+            _vmtf_search = x;
         }
     }
 
-    if (v != VARIABLE_UNDEF) {
-        _polarity[v] = !_polarity[v];
-        return _polarity[v] ? Literal(v) : ~Literal(v);
+    _vmtf_bumped.clear();
+}
+
+/**
+ * compute_lbd : (c : const C&) -> [int]
+ * 
+ * Description:
+ *  Count the distinct decision levels of the literals in c ("glue").
+ * 
+ * Reference:
+ * [AS09] G. Audemard, L. Simon. "Predicting Learnt Clauses Quality in Modern 
+ * SAT Solvers", IJCAI, 2009
+ */
+template<typename C>
+int Solver::compute_lbd(const C& c) {
+    int lbd = 0;
+    _lbd_stamp++;
+
+    for (int i = 0; i < c.size(); i++) {
+        int l = level(c[i].variable());
+        if (_level_stamp[l] != _lbd_stamp) {
+            _level_stamp[l] = _lbd_stamp;
+            lbd++;
+        }
     }
 
-    return LITERAL_UNDEF;
+    return lbd;
 }
 
+/**
+ * restart_needed : (void) -> [bool]
+ * 
+ * Description:
+ *  Restart if the fast moving average of the LBDs exceeds the slow one by 
+ *  the restart margin, i.e. the recently learnt clauses are bad.
+ * 
+ * Reference:
+ * [AS12] G. Audemard, L. Simon. "Refining Restarts Strategies for SAT and 
+ * UNSAT", CP, 2012
+ * [BF15] A. Biere, A. Fröhlich. "Evaluating CDCL Restart Schemes", POS, 2015
+ */
+inline bool Solver::restart_needed(void) {
+    return _lbd_window >= 50 && _lbd_fast.value > _restart_margin * _lbd_slow.value;
+}
+
+/**
+ * within_budget : (void) -> [bool]
+ * 
+ * Description:
+ *  False once 'solve_limited' has to stop: on an interrupt, or when the
+ *  conflict, propagation, memory or time budget is used up. The clock is only
+ *  read every 256 calls.
+ */
+inline bool Solver::within_budget(void) {
+    if (_interrupted.load(std::memory_order_relaxed)) { return false; }
+    if (_conflict_budget >= 0 && _n_conflicts >= (uint64_t)_conflict_budget) { return false; }
+    if (_propagation_budget >= 0 && _n_propagations >= (uint64_t)_propagation_budget) { return false; }
+    if (_memory_budget > 0 && (uint64_t)_ca.size() * sizeof(uint32_t) > _memory_budget) { return false; }
+
+    // Reading the clock is not free, it is checked every 256 calls
+    if (_time_budget_on && (++_budget_checks & 255) == 0) {
+        if (std::chrono::steady_clock::now() >= _time_budget) {
+            // Read the clock again on the next call
+            _budget_checks--;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * reduce_db : (void) -> [void]
+ * 
+ * Description:
+ *  Remove about half of the learnt clauses that are neither core nor recently
+ *  used tier2 clauses. The candidates with the highest LBD and the lowest 
+ *  activity go first. Clauses that are reasons for a current assignment are 
+ *  never removed.
+ * 
+ * Reference:
+ * [AS09] G. Audemard, L. Simon. "Predicting Learnt Clauses Quality in Modern 
+ * SAT Solvers", IJCAI, 2009
+ * [Oh15] C. Oh. "Between SAT and UNSAT: The Fundamental Difference in CDCL 
+ * SAT", Proc. of SAT, 2015
+ */
+void Solver::reduce_db(void) {
+    _n_reduce_db++;
+    _reduce_interval += _reduce_inc;
+    _next_reduce_db = _n_conflicts + _reduce_interval;
+
+    // Split into kept clauses (front of '_learnts') and removal candidates:
+    Vector<CRARef> candidates;
+    int i, j;
+    for (i = j = 0; i < _learnts.size(); i++) {
+        Clause& c = _ca[_learnts[i]];
+        bool keep = c.lbd() <= _core_lbd || (c.lbd() <= _tier2_lbd && c.used());
+
+        c.used(false);
+        if (keep) {
+            _learnts[j++] = _learnts[i];
+        } else {
+            candidates.push(_learnts[i]);
+        }
+    }
+    _learnts.shrink(i - j);
+
+    const ClauseAllocator& ca = _ca;
+    std::sort(candidates.begin(), candidates.end(), [&](CRARef x, CRARef y) -> bool {
+        if (ca[x].lbd() != ca[y].lbd()) { return ca[x].lbd() > ca[y].lbd(); }
+        return ca[x].activity() < ca[y].activity();
+    });
+
+    int limit = candidates.size() / 2;
+    for (i = 0; i < candidates.size(); i++) {
+        Clause& c = _ca[candidates[i]];
+        if (i < limit && !is_locked(c)) {
+            remove_clause(candidates[i]);
+            _n_removed_learnts++;
+        } else {
+            _learnts.push(candidates[i]);
+        }
+    }
+
+    check_garbage();
+}
+
+/**
+ * search : (n_conflicts : int) -> [LiftedBoolean]
+ * 
+ * Description:
+ *  Search for a model the specified number of conflicts (n_conflicts < 0 
+ *  means no limit). For RESTART_GLUCOSE the search is interrupted when 
+ *  'restart_needed' holds instead.
+ * 
+ * Output:
+ *  LIFTED_BOOLEAN_TRUE if a partial assigment that is consistent with respect 
+ *  to the clauseset is found. If all variables are decision variables, this 
+ *  means that the clause set is satisfiable. LIFTED_BOOLEAN_FALSE if the 
+ *  clause set is unsatisfiable. LIFTED_BOOLEAN_UNDEF if the bound on number 
+ *  of conflicts is reached (a restart).
+ */
 LiftedBoolean Solver::search(int n_conflicts) {
     if (_myyura != true) {
         throw;
@@ -310,32 +754,107 @@ LiftedBoolean Solver::search(int n_conflicts) {
 
     Vector<Literal> learnt_clause;
     int backtrack_level;
+    int conflict_count = 0;
 
     for (; ;) {
         // Propagation
         CRARef conflict = propagate();
-        std::cout << conflict << std::endl;
         if (conflict != CRAREF_UNDEF) {
-            if (decision_level() == 0) { return LIFTED_BOOLEAN_FALSE; }
+            _n_conflicts++;
+            conflict_count++;
+            if (decision_level() == 0) {
+                if (_proof != NULL) { proof_empty_clause(conflict); }
+                return LIFTED_BOOLEAN_FALSE;
+            }
+
+            // Block the restart if the solver seems to approach a model:
+            _lbd_window++;
+            if (_restart_policy == RESTART_GLUCOSE && _n_conflicts > 10000 && _lbd_window >= 50
+                && _trail.size() > _restart_block * _trail_slow.value) {
+                _n_blocked_restarts++;
+                _lbd_window = 0;
+            }
+            _trail_slow.update(_trail.size());
 
             learnt_clause.clear();
             analyze(conflict, learnt_clause, backtrack_level);
+
+            uint64_t id = 0;
+            if (_proof != NULL) {
+                id = new_clause_id();
+                _proof_hints.clear();
+                if (lrat()) { proof_chain(conflict, learnt_clause); }
+                proof_add(learnt_clause, learnt_clause.size(), id);
+            }
+
+            int lbd = compute_lbd(learnt_clause);
+            _lbd_fast.update(lbd);
+            _lbd_slow.update(lbd);
+
             cancel_until(backtrack_level);
+            variable_decay_activity();
+            clause_decay_activity();
 
             if (learnt_clause.size() == 1) {
                 unchecked_enqueue(learnt_clause[0]);
+                if (_proof != NULL) { _unit_id[learnt_clause[0].variable()] = id; }
             } else {
                 CRARef cr = _ca.alloc(learnt_clause, true);
+                if (_ca.clause_ids()) { _ca[cr].id(id); }
+                _ca[cr].lbd(lbd);
+                clause_bump_activity(_ca[cr]);
                 _learnts.push(cr);
                 attach_clause_watcher(cr);
                 unchecked_enqueue(learnt_clause[0], cr);
             }
         } else {
             // NO CONFLICT
+            if (decision_level() == 0 && lrat()) { proof_units(); }
+
+            // Simplify the set of problem clauses:
+            if (decision_level() == 0 && !simplify()) { return LIFTED_BOOLEAN_FALSE; }
+
+            if (!within_budget()) {
+                // Out of budget, the caller may resume from the top level
+                cancel_until(0);
+                return LIFTED_BOOLEAN_UNDEF;
+            }
+
+            if ((n_conflicts >= 0 && conflict_count >= n_conflicts) || 
+                (_restart_policy == RESTART_GLUCOSE && restart_needed())) {
+                // Reached bound on number of conflicts:
+                _n_restarts++;
+                _trace.log(TRACE_DECIDE, 1, "restart %llu: trail %d", (unsigned long long)_n_restarts, _trail.size());
+                _n_restart_trail += _trail.size();
+                _lbd_window = 0;
+                cancel_until(0);
+                return LIFTED_BOOLEAN_UNDEF;
+            }
+
+            if (_n_conflicts >= _next_reduce_db) {
+                // Reduce the set of learnt clauses:
+                reduce_db();
+            }
+
             Literal next = LITERAL_UNDEF;
+            for (; decision_level() < _assumptions.size();) {
+                // Perform user provided assumption:
+                Literal p = _assumptions[decision_level()];
+                if (value(p) == LIFTED_BOOLEAN_TRUE) {
+                    // Dummy decision level:
+                    new_decision_level();
+                } else if (value(p) == LIFTED_BOOLEAN_FALSE) {
+                    analyze_final(~p, _conflict);
+                    return LIFTED_BOOLEAN_FALSE;
+                } else {
+                    next = p;
+                    break;
+                }
+            }
 
             if (next == LITERAL_UNDEF){
                 // New variable decision:
+                _n_decisions++;
                 next = pick_branch_literal();
 
                 if (next == LITERAL_UNDEF)
@@ -344,8 +863,128 @@ LiftedBoolean Solver::search(int n_conflicts) {
             }
 
             // Increase decision level and enqueue 'next'
+            _trace.log(TRACE_DECIDE, 1, "decide %d at level %d", next.to_int(), decision_level() + 1);
             new_decision_level();
             unchecked_enqueue(next);
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * luby : (y : double) (x : int) -> [double]
+ * 
+ * Description:
+ *  Finite subsequences of the Luby-sequence:
+ * 
+ *  0: 1
+ *  1: 1 1 2
+ *  2: 1 1 2 1 1 2 4
+ *  3: 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8
+ *  ...
+ * 
+ * Reference:
+ * [LSZ93] M. Luby, A. Sinclair, D. Zuckerman. "Optimal speedup of Las Vegas 
+ * algorithms", Information Processing Letters, 1993
+ */
+static double luby(double y, int x) {
+    // Find the finite subsequence that contains index 'x', and the
+    // size of that subsequence:
+    int size, seq;
+    for (size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1) {}
+
+    for (; size - 1 != x;) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+
+    return std::pow(y, seq);
+}
+
+/**
+ * _solve : (void) -> [LiftedBoolean]
+ * 
+ * Description:
+ *  Main solve method, call 'search' with the restart limits given by the 
+ *  restart policy until the problem is solved or a budget is exhausted
+ *  (LIFTED_BOOLEAN_UNDEF). The solver is then back at the top level with its
+ *  learnt clauses, and the next call continues from there.
+ */
+LiftedBoolean Solver::_solve(void) {
+    _model_value.clear();
+    _conflict.clear();
+    if (!_myyura) { return LIFTED_BOOLEAN_FALSE; }
+
+    // The open scopes are assumed before the user's assumptions
+    if (_scopes.size() > 0) {
+        int n = _assumptions.size();
+        _assumptions.grow_to(n + _scopes.size());
+        for (int i = n - 1; i >= 0; i--) {
+            _assumptions[i + _scopes.size()] = _assumptions[i];
+        }
+        for (int i = 0; i < _scopes.size(); i++) {
+            _assumptions[i] = _scopes[i];
+        }
+    }
+
+    // Eliminated variables (and the ones blocked clauses may flip) can't be 
+    // assumed
+    for (int i = 0; i < _assumptions.size(); i++) {
+        if (is_extended(_assumptions[i].variable())) { restore_variable(_assumptions[i].variable()); }
+    }
+
+    // Problem clauses added or strengthened since the last call
+    if (!_myyura || !extract_xors() || !substitute() || !eliminate()) { return LIFTED_BOOLEAN_FALSE; }
+
+    LiftedBoolean status = LIFTED_BOOLEAN_UNDEF;
+
+    // Search:
+    for (; status == LIFTED_BOOLEAN_UNDEF && within_budget(); _restart_index++) {
+        // Probing and vivification between restarts, each with a share of 
+        // the search propagations
+        if ((_probing || _vivification) && _n_conflicts >= _next_probe) {
+            uint64_t ticks = std::max((uint64_t)(_probe_ratio * (_n_propagations - _probe_propagations)), _probe_min_ticks);
+            if ((_probing && (!probe(ticks) || !substitute())) || !vivify(ticks)) {
+                status = LIFTED_BOOLEAN_FALSE;
+                break;
+            }
+            _next_probe = _n_conflicts + _probe_interval;
+            _probe_propagations = _n_propagations;
+        }
+
+        double n_conflicts = -1;
+        if (_restart_policy == RESTART_LUBY) {
+            n_conflicts = luby(_restart_inc, _restart_index) * _restart_first;
+        } else if (_restart_policy == RESTART_GEOMETRIC) {
+            n_conflicts = std::pow(_restart_inc, _restart_index) * _restart_first;
+        }
+
+        status = search((int)std::min(n_conflicts, (double)std::numeric_limits<int>::max()));
+    }
+
+    if (status != LIFTED_BOOLEAN_UNDEF) { _restart_index = 0; }
+
+    if (status == LIFTED_BOOLEAN_TRUE) {
+        // Extend & copy model:
+        _model_value.grow_to(n_variables());
+        for (Variable x = 0; x < n_variables(); x++) {
+            _model_value[x] = value(x);
+        }
+        extend_model();
+    } else if (status == LIFTED_BOOLEAN_FALSE && _conflict.size() == 0) {
+        _myyura = false;
+    } else if (status == LIFTED_BOOLEAN_FALSE && _scopes.size() > 0) {
+        // Only report the user's assumptions
+        Vector<Literal> conflict;
+        _conflict.to_vector().copy_to(conflict);
+        _conflict.clear();
+        for (int i = 0; i < conflict.size(); i++) {
+            if (std::find(_scopes.begin(), _scopes.end(), ~conflict[i]) == _scopes.end()) {
+                _conflict.insert(conflict[i]);
+            }
+        }
+    }
+
+    cancel_until(0);
+    return status;
+}
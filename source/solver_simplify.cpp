@@ -15,6 +15,10 @@ inline void Solver::touch(const Variable& x) {
         _touched[x] = 1;
         _touched_list.push(x);
     }
+    if (!_elim_touched[x]) {
+        _elim_touched[x] = 1;
+        _elim_touched_list.push(x);
+    }
 }
 
 inline void Solver::touch(const Literal& p) {
@@ -28,11 +32,12 @@ void Solver::attach_clause_occlit(CRARef cr, CRARef overwrite) {
     for (int i = 0; i < c.size(); i++) {
         _occur_lit[c[i]].push(cr);
         touch(c[i]);
-        if (overwrite == CRAREF_UNDEF) {
-            _added.insert(cr);
-        } else {
-            _strengthened.insert(cr);
-        }
+    }
+
+    if (overwrite == CRAREF_UNDEF) {
+        _added.insert(cr);
+    } else {
+        _strengthened.insert(cr);
     }
 }
 
@@ -57,15 +62,18 @@ void Solver::detach_clause_occlit(CRARef cr, bool strict) {
 }
 
 /**
- * toplevel_remove_clause : (cs : Vector<Clause*>&) -> [void]
+ * toplevel_simplify_satisfied_clause : (cs : Vector<Clause*>&) -> [void]
  * 
  * Description:
  *  Remove all clauses (in cs) that are already satisfied in the toplevel.
  *  Remove all literals that are assigned to FALSE (in the toplevel) in an 
- *  unsatisfied clause (in cs).
+ *  unsatisfied clause (in cs). 'cs' is compacted. A shortened problem clause
+ *  is queued in '_strengthened', a removed one in '_subsumption_removed' 
+ *  (its occurence lists are cleaned by the caller).
  *  
- * Post-condition:
- *  Omitted
+ * Pre-condition:
+ *  The top-level assignments are propagated, so the watched literals of an 
+ *  unsatisfied clause are not false
  */
 void Solver::toplevel_simplify_satisfied_clause(Vector<CRARef>& cs) {
     if (decision_level() != 0) {
@@ -74,15 +82,67 @@ void Solver::toplevel_simplify_satisfied_clause(Vector<CRARef>& cs) {
 
     int i, j;
     for (i = j = 0; i < cs.size(); i++) {
-        Clause& c = _ca[cs[i]];
+        CRARef cr = cs[i];
+        if (is_removed(cr)) { continue; }
+
+        Clause& c = _ca[cr];
         if (is_satisfied(c) == LIFTED_BOOLEAN_TRUE) {
-            remove_clause(cs[i]);
+            remove_clause(cr);
+            if (!c.learnt()) { _subsumption_removed.push(cr); }
+            continue;
+        }
+        cs[j++] = cr;
+
+        if (CHECKS_ENABLED && (is_false(c[0]) || is_false(c[1]))) {
+            throw std::logic_error("Solver::toplevel_simplify_satisfied_clause : a watched literal is false");
+        }
+
+        int k = 2;
+        for (; k < c.size() && !is_false(c[k]); k++) {}
+        if (k == c.size()) { continue; }
+
+        // Trim clause, the watched literals stay in place
+        if (_proof != NULL) {
+            _proof_literals.clear();
+            _proof_hints.clear();
+            for (k = 0; k < c.size(); k++) {
+                if (!is_false(c[k])) {
+                    _proof_literals.push(c[k]);
+                } else if (lrat()) {
+                    _proof_hints.push(_unit_id[c[k].variable()]);
+                }
+            }
+            if (lrat()) { _proof_hints.push(c.id()); }
+
+            uint64_t id = new_clause_id();
+            proof_add(_proof_literals, _proof_literals.size(), id);
+            proof_remove(c);
+            if (c.has_id()) { c.id(id); }
+        }
+
+        // A clause that becomes binary gets binary watchers
+        int n = 2;
+        for (k = 2; k < c.size(); k++) {
+            if (!is_false(c[k])) { n++; }
+        }
+        if (n == 2) { detach_clause_watcher(cr, true); }
+
+        int l;
+        for (k = l = 2; k < c.size(); k++) {
+            if (!is_false(c[k])) { c[l++] = c[k]; }
+        }
+        c.shrink(k - l);
+
+        if (n == 2) { attach_clause_watcher(cr); }
+        if (c.learnt()) {
+            if ((int)c.lbd() > c.size()) { c.lbd(c.size()); }
         } else {
-            // TODO: trim clause
+            c.calc_abstraction();
+            _strengthened.insert(cr);
         }
     }
 
-    // cs.shrink(i - j);
+    cs.shrink(i - j);
 }
 
 /**
@@ -100,7 +160,7 @@ bool Solver::is_subsumed(CRARef cr) {
             if (is_removed(crs[j])) { continue; }
 
             Clause& cp = _ca[crs[j]];
-            if (cr != crs[i] && cp.subsumes(c) == LITERAL_UNDEF) {
+            if (cr != crs[j] && cp.subsumes(c) == LITERAL_UNDEF) {
                 return true;
             }
         }
@@ -109,6 +169,64 @@ bool Solver::is_subsumed(CRARef cr) {
     return false;
 }
 
+/**
+ * subsume_batch : (cs : Vector<Clause*>&) -> [void]
+ * 
+ * Description:
+ *  Remove all clauses subsumed by another clause, where 'cs' are the clauses 
+ *  pending in a bulk load (in the occurence lists, but not watched yet). Every
+ *  clause, pending or not, is checked against the occurence list of its 
+ *  rarest literal only (backward subsumption), shortest clauses first.
+ *  Subsumed pending clauses are marked as removed, the others are removed 
+ *  with 'remove_clause'.
+ */
+void Solver::subsume_batch(Vector<CRARef>& cs) {
+    Vector<CRARef> order;
+    order.reserve(_clauses.size() + cs.size());
+    for (int i = 0; i < _clauses.size(); i++) {
+        if (!is_removed(_clauses[i])) { order.push(_clauses[i]); }
+    }
+    for (int i = 0; i < cs.size(); i++) { order.push(cs[i]); }
+
+    std::stable_sort(order.begin(), order.end(), [&](CRARef x, CRARef y) -> bool {
+        return _ca[x].size() < _ca[y].size();
+    });
+
+    for (int i = 0; i < order.size(); i++) {
+        if (is_removed(order[i])) { continue; }
+        const Clause& c = _ca[order[i]];
+
+        int min_i = 0;
+        for (int k = 1; k < c.size(); k++) {
+            if (_occur_lit[c[k]].size() < _occur_lit[c[min_i]].size()) {
+                min_i = k;
+            }
+        }
+
+        Vector<CRARef>& crs = _occur_lit[c[min_i]];
+        for (int j = 0; j < crs.size(); j++) {
+            if (crs[j] == order[i] || is_removed(crs[j])) { continue; }
+
+            Clause& cp = _ca[crs[j]];
+            if (c.subsumes(cp) == LITERAL_UNDEF) {
+                for (int k = 0; k < cp.size(); k++) {
+                    _occur_lit.smudge(cp[k]);
+                }
+
+                if (crs[j] >= _bulk_start) {
+                    if (_proof != NULL) { proof_remove(cp); }
+                    cp.mark(1);
+                    _ca.free(crs[j]);
+                } else {
+                    remove_clause(crs[j]);
+                }
+            }
+        }
+    }
+
+    _occur_lit.clean_all();
+}
+
 /**
  * subsume0 : (cr : Clause*) -> [void]
  * 
@@ -141,58 +259,1675 @@ void Solver::subsume0(CRARef cr) {
 }
 
 /**
- * subsume1 : (cr : Clause*) -> [void]
+ * strengthen_clause : (cr : Clause*) (p : Literal) (by : uint64_t) -> [bool]
  * 
  * Description:
- *  Strengthen all clauses that are selfsubsumed by clause (*cr)
+ *  Remove the literal 'p' from the problem clause (*cr), which must not be 
+ *  satisfied. 'by' is the proof id of the clause (or unit) that, together 
+ *  with (*cr), implies the shorter clause (LRAT). The clause is watched again
+ *  and queued in '_strengthened', a clause that became a unit is propagated.
+ *  Returns false if the problem turned out to be unsatisfiable.
  */
-void Solver::subsume1(CRARef cr) {
-    // TODO : flag to turn off
-    Vector<CRARef> subs_queue;
-    int q;
-    for (q = 0, subs_queue.push(cr); q < subs_queue.size(); q++) {
-        if (is_removed(subs_queue[q])) { q++; continue; }
-        Clause& c = _ca[subs_queue[q]];
+bool Solver::strengthen_clause(CRARef cr, Literal p, uint64_t by) {
+    Clause& c = _ca[cr];
+    if (_proof != NULL) { proof_strengthen(cr, p, by); }
 
-        int min_i = 0;
-        for (int i = 0; i < c.size(); i++) {
-            if (_occur_lit[c[i]].size() < _occur_lit[c[min_i]].size()) {
-                min_i = i;
-            }
+    detach_clause_watcher(cr, true);
+    remove(_occur_lit[p], cr);
+    touch(p);
+    c.strengthen(p);
+    _n_strengthened++;
+
+    // The literals to watch (not false) go first
+    int k = 0;
+    for (int i = 0; i < c.size() && k < 2; i++) {
+        if (!is_false(c[i])) { std::swap(c[i], c[k++]); }
+    }
+
+    if (k == 0) {
+        if (_proof != NULL) { proof_empty_clause(cr); }
+        return _myyura = false;
+    } else if (c.size() == 1) {
+        // The proof keeps the clause as the unit
+        if (_proof != NULL) { _unit_id[c[0].variable()] = c.has_id() ? c.id() : 0; }
+        unchecked_enqueue(c[0]);
+        c.mark(1);
+        _ca.free(cr);
+        _subsumption_removed.push(cr);
+    } else {
+        attach_clause_watcher(cr);
+        _strengthened.insert(cr);
+        if (k == 1) { unchecked_enqueue(c[0], cr); }
+    }
+
+    if (k == 1) {
+        CRARef conflict = propagate();
+        if (conflict != CRAREF_UNDEF) {
+            if (_proof != NULL) { proof_empty_clause(conflict); }
+            return _myyura = false;
         }
+        if (lrat()) { proof_units(); }
+    }
 
-        Vector<CRARef>& crs = _occur_lit[c[min_i]];
-        for (int i = 0; i < crs.size(); i++) {
-            if (is_removed(crs[i])) { continue; }
+    return true;
+}
+
+/**
+ * subsume1 : (cr : Clause*) (effort : int64_t&) -> [bool]
+ * 
+ * Description:
+ *  Remove all clauses that are subsumed by clause (*cr) and strengthen all 
+ *  clauses that are selfsubsumed by it. The candidates are the clauses with 
+ *  the variable of (*cr) that has the fewest occurences, each one visited 
+ *  takes one from 'effort'. Returns false if the problem turned out to be 
+ *  unsatisfiable.
+ */
+bool Solver::subsume1(CRARef cr, int64_t& effort) {
+    const Clause& c = _ca[cr];
+
+    int min_i = 0;
+    for (int i = 1; i < c.size(); i++) {
+        if (_occur_lit[c[i]].size() + _occur_lit[~c[i]].size() < 
+            _occur_lit[c[min_i]].size() + _occur_lit[~c[min_i]].size()) {
+            min_i = i;
+        }
+    }
 
-            if (cr != crs[i]) {
-                Clause& cp = _ca[crs[i]];
-                Literal p = c.subsumes(cp);
-                if (p != LITERAL_UNDEF && p != LITERAL_ERROR) {
-                    // _selfsubsumption_removed++;
-                    cp.strengthen(p);
-                    subs_queue.push(crs[i]);
+    Literal qs[] = { c[min_i], ~c[min_i] };
+    for (Literal q : qs) {
+        // Backwards, strengthening removes the current clause from the list
+        Vector<CRARef>& crs = _occur_lit[q];
+        for (int i = crs.size() - 1; i >= 0; i--) {
+            if (crs[i] == cr || is_removed(crs[i])) { continue; }
+            effort--;
+
+            Clause& cp = _ca[crs[i]];
+            Literal p = c.subsumes(cp);
+            if (p == LITERAL_UNDEF) {
+                _n_subsumed++;
+                remove_clause(crs[i]);
+                _subsumption_removed.push(crs[i]);
+            } else if (p != LITERAL_ERROR) {
+                if (is_satisfied(cp) == LIFTED_BOOLEAN_TRUE) {
+                    remove_clause(crs[i]);
+                    _subsumption_removed.push(crs[i]);
+                } else if (!strengthen_clause(crs[i], ~p, lrat() ? c.id() : 0)) {
+                    return false;
                 }
             }
         }
     }
 
-    check_garbage();
+    return true;
 }
 
 /**
- * reduction_by_subsumption : (void) -> [void]
+ * reduction_by_subsumption : (effort : int64_t&) -> [bool]
  * 
  * Description:
- *  Simlify the clause database by subsumption (subsume0) and selfsubsumption
- *  (subsume1).
+ *  Simplify the problem clauses by subsumption and selfsubsumption (subsume1)
+ *  [EB05]. Top-level assignments made since the last call are applied first:
+ *  the satisfied clauses are removed and the false literals are removed from
+ *  the others. Then every clause in '_added' or '_strengthened', or with a 
+ *  variable in '_touched_list', is checked against the clauses with its 
+ *  rarest variable, shortest clauses first. Strengthened clauses are checked
+ *  again, until nothing changes or 'effort' occurence list visits are 
+ *  spent. Returns false if the problem turned out to be unsatisfiable.
  * 
  * Post-conditions:
- *  (1) No opportunities remain for subsumption or selfsubsumption
- *  (2) The two sets _added and _strengthened are empty
+ *  (1) Unless the effort ran out, no opportunities remain for subsumption or
+ *  selfsubsumption
+ *  (2) The clauses not checked yet are left in '_subsumption_queue'
  */
-void Solver::reduction_by_subsumption(void) {
+bool Solver::reduction_by_subsumption(int64_t& effort) {
     if (decision_level() != 0) {
         throw std::logic_error("Solver::reduction_by_subsumption : we are not in the toplevel!");
     }
-}
\ No newline at end of file
+    if (!_myyura) { return false; }
+    if (_subsumption_effort == 0) { return true; }
+
+    // Clauses in the queue are marked with 2
+    Vector<CRARef> queue;
+    _subsumption_queue.move_to(queue);
+    int head = 0;
+
+    for (;;) {
+        // Top-level assignments, as if each one were a unit clause in the queue
+        if (lrat()) { proof_units(); }
+        for (; _subsumption_head < _trail.size(); _subsumption_head++) {
+            Literal p = _trail[_subsumption_head];
+
+            Vector<CRARef>& crs = _occur_lit[p];
+            for (int i = 0; i < crs.size(); i++) {
+                if (is_removed(crs[i])) { continue; }
+                effort--;
+                remove_clause(crs[i]);
+                _subsumption_removed.push(crs[i]);
+            }
+
+            Vector<CRARef>& ncrs = _occur_lit[~p];
+            for (int i = ncrs.size() - 1; i >= 0; i--) {
+                if (is_removed(ncrs[i])) { continue; }
+                effort--;
+                if (is_satisfied(_ca[ncrs[i]]) == LIFTED_BOOLEAN_TRUE) {
+                    remove_clause(ncrs[i]);
+                    _subsumption_removed.push(ncrs[i]);
+                } else if (!strengthen_clause(ncrs[i], ~p, _unit_id[p.variable()])) {
+                    return false;
+                }
+            }
+        }
+
+        if (head == queue.size()) {
+            queue.clear();
+            head = 0;
+
+            for (CRARef cr : _added) {
+                if (!is_removed(cr) && _ca[cr].mark() == 0) { _ca[cr].mark(2); queue.push(cr); }
+            }
+            for (CRARef cr : _strengthened) {
+                if (!is_removed(cr) && _ca[cr].mark() == 0) { _ca[cr].mark(2); queue.push(cr); }
+            }
+            for (int i = 0; i < _touched_list.size(); i++) {
+                Variable x = _touched_list[i];
+                _touched[x] = 0;
+                for (int sign = 0; sign < 2; sign++) {
+                    Vector<CRARef>& crs = _occur_lit[Literal(x, sign)];
+                    for (int j = 0; j < crs.size(); j++) {
+                        if (_ca[crs[j]].mark() == 0) { _ca[crs[j]].mark(2); queue.push(crs[j]); }
+                    }
+                }
+            }
+            _added.clear();
+            _strengthened.clear();
+            _touched_list.clear();
+
+            if (queue.size() == 0) { break; }
+
+            // Sorted by size, then by reference (the order they were added)
+            Vector<uint64_t> keys(queue.size());
+            for (int i = 0; i < queue.size(); i++) {
+                keys[i] = ((uint64_t)_ca[queue[i]].size() << 32) | queue[i];
+            }
+            std::sort(keys.begin(), keys.end());
+            for (int i = 0; i < queue.size(); i++) {
+                queue[i] = (CRARef)keys[i];
+            }
+        }
+
+        if (effort <= 0) { break; }
+
+        CRARef cr = queue[head++];
+        if (is_removed(cr)) { continue; }
+        _ca[cr].mark(0);
+
+        if (is_satisfied(_ca[cr]) == LIFTED_BOOLEAN_TRUE) {
+            remove_clause(cr);
+            _subsumption_removed.push(cr);
+        } else if (!subsume1(cr, effort)) {
+            return false;
+        }
+    }
+
+    // Out of effort, the rest waits for the next call
+    for (; head < queue.size(); head++) {
+        if (!is_removed(queue[head])) { _subsumption_queue.push(queue[head]); }
+    }
+
+    for (int i = 0; i < _subsumption_removed.size(); i++) {
+        const Clause& c = _ca[_subsumption_removed[i]];
+        for (int k = 0; k < c.size(); k++) {
+            _occur_lit.smudge(c[k]);
+        }
+    }
+    _subsumption_removed.clear();
+    _occur_lit.clean_all();
+
+    check_garbage();
+    return true;
+}
+
+inline void Solver::decision(Variable x, bool b) {
+    if (b && !_decision[x]) { _n_decision_variables++; }
+    if (!b && _decision[x]) { _n_decision_variables--; }
+    _decision[x] = (char)b;
+    insert_variable_order(x);
+    // The VMTF search may have passed it already
+    if (b && _vmtf_links[x].stamp > _vmtf_links[_vmtf_search].stamp) {
+        _vmtf_search = x;
+    }
+}
+
+inline bool Solver::is_eliminable(Variable x) const {
+    return _eliminated[x] < 0 && _frozen[x] == 0 && _decision[x] && value(x) == LIFTED_BOOLEAN_UNDEF;
+}
+
+// The value of 'x' in the model is set (or may be flipped) by 'extend_model'
+inline bool Solver::is_extended(Variable x) const {
+    return _eliminated[x] >= 0 || _witness[x] > 0;
+}
+
+/**
+ * resolvent : (c : const Clause&) (d : const Clause&) (x : Variable) (out : Vector<Literal>&) -> [int]
+ * 
+ * Description:
+ *  The resolvent of 'c' and 'd' on 'x' into 'out', without duplicate 
+ *  literals. Returns its size, or -1 if it is a tautology.
+ */
+int Solver::resolvent(const Clause& c, const Clause& d, Variable x, Vector<Literal>& out) {
+    out.clear();
+    // '_seen': 1 - in 'c' positively, 2 - negatively
+    for (int i = 0; i < c.size(); i++) {
+        if (c[i].variable() != x) {
+            _seen[c[i].variable()] = 1 + c[i].sign();
+            out.push(c[i]);
+        }
+    }
+
+    bool tautology = false;
+    for (int i = 0; i < d.size() && !tautology; i++) {
+        Variable y = d[i].variable();
+        if (y == x) { continue; }
+
+        if (_seen[y] == 0) {
+            out.push(d[i]);
+        } else if (_seen[y] != 1 + d[i].sign()) {
+            tautology = true;
+        }
+    }
+
+    for (int i = 0; i < c.size(); i++) {
+        _seen[c[i].variable()] = 0;
+    }
+
+    return tautology ? -1 : out.size();
+}
+
+/**
+ * add_resolvent : (ps : Vector<Literal>&) (c_id : uint64_t) (d_id : uint64_t) -> [bool]
+ * 
+ * Description:
+ *  Add the resolvent 'ps' of the clauses with the proof ids 'c_id' (the one 
+ *  with the positive literal) and 'd_id' as a problem clause. True literals 
+ *  are handled as in '_add_clause', a unit is propagated. Also puts back the 
+ *  clauses of a restored variable (no proof). Returns false if the problem 
+ *  turned out to be unsatisfiable.
+ */
+bool Solver::add_resolvent(Vector<Literal>& ps, uint64_t c_id, uint64_t d_id) {
+    _proof_hints.clear();
+
+    int i, j;
+    for (i = j = 0; i < ps.size(); i++) {
+        if (is_true(ps[i])) {
+            return true;
+        } else if (is_false(ps[i])) {
+            if (lrat()) { _proof_hints.push(_unit_id[ps[i].variable()]); }
+        } else {
+            ps[j++] = ps[i];
+        }
+    }
+    ps.shrink(i - j);
+
+    uint64_t id = 0;
+    if (_proof != NULL) {
+        if (lrat()) {
+            _proof_hints.push(c_id);
+            _proof_hints.push(d_id);
+        }
+        id = new_clause_id();
+        proof_add(ps, ps.size(), id);
+    }
+
+    if (ps.size() == 0) {
+        return _myyura = false;
+    } else if (ps.size() == 1) {
+        unchecked_enqueue(ps[0]);
+        if (_proof != NULL) { _unit_id[ps[0].variable()] = id; }
+
+        CRARef conflict = propagate();
+        if (conflict != CRAREF_UNDEF) {
+            if (_proof != NULL) { proof_empty_clause(conflict); }
+            return _myyura = false;
+        }
+        if (lrat()) { proof_units(); }
+    } else {
+        CRARef cr = _ca.alloc(ps, false);
+        if (_ca.clause_ids()) { _ca[cr].id(id); }
+
+        _clauses.push(cr);
+        attach_clause_watcher(cr);
+        attach_clause_occlit(cr);
+    }
+
+    return true;
+}
+
+/**
+ * eliminate_variable : (x : Variable) (effort : int64_t&) -> [bool]
+ * 
+ * Description:
+ *  Replace the clauses with 'x' by all their non-tautological resolvents on 
+ *  'x' [EB05], if there are at most '_elim_grow' more resolvents than 
+ *  clauses and none is longer than '_elim_clause_limit'. The clauses are 
+ *  kept in a record for 'extend_model'. Every pair of clauses tried takes 
+ *  one from 'effort'. Returns false if the problem turned out to be 
+ *  unsatisfiable.
+ */
+bool Solver::eliminate_variable(Variable x, int64_t& effort) {
+    Vector<CRARef> pos, neg;
+    const Vector<CRARef>& xs = _occur_lit[Literal(x)];
+    for (int i = 0; i < xs.size(); i++) {
+        if (!is_removed(xs[i])) { pos.push(xs[i]); }
+    }
+    const Vector<CRARef>& nxs = _occur_lit[~Literal(x)];
+    for (int i = 0; i < nxs.size(); i++) {
+        if (!is_removed(nxs[i])) { neg.push(nxs[i]); }
+    }
+
+    if (pos.size() + neg.size() > _elim_occurence_limit) { return true; }
+
+    // Check that the number of clauses does not grow too much
+    Vector<Literal>& out = _add_clause_temp;
+    int n_resolvents = 0;
+    for (int i = 0; i < pos.size(); i++) {
+        for (int j = 0; j < neg.size(); j++) {
+            effort--;
+            int size = resolvent(_ca[pos[i]], _ca[neg[j]], x, out);
+            if (size >= 0 && (++n_resolvents > pos.size() + neg.size() + _elim_grow 
+                || size > _elim_clause_limit)) {
+                return true;
+            }
+        }
+    }
+
+    // Keep the clauses for the model
+    int begin = _elim_clauses.size();
+    for (int k = 0; k < 2; k++) {
+        const Vector<CRARef>& crs = k == 0 ? pos : neg;
+        for (int i = 0; i < crs.size(); i++) {
+            const Clause& c = _ca[crs[i]];
+            _elim_clauses.push(c.size());
+            for (int l = 0; l < c.size(); l++) {
+                _elim_clauses.push(c[l].to_int());
+            }
+        }
+    }
+    _eliminated[x] = _elim_records.size();
+    _elim_records.push(_Elimination(x, begin, _elim_clauses.size()));
+    decision(x, false);
+    _n_eliminated++;
+
+    // The resolvents before the clauses are removed, the proof needs them
+    for (int i = 0; i < pos.size(); i++) {
+        for (int j = 0; j < neg.size(); j++) {
+            const Clause& c = _ca[pos[i]];
+            const Clause& d = _ca[neg[j]];
+            if (resolvent(c, d, x, out) >= 0 && 
+                !add_resolvent(out, lrat() ? c.id() : 0, lrat() ? d.id() : 0)) {
+                return false;
+            }
+        }
+    }
+
+    for (int k = 0; k < 2; k++) {
+        const Vector<CRARef>& crs = k == 0 ? pos : neg;
+        for (int i = 0; i < crs.size(); i++) {
+            const Clause& c = _ca[crs[i]];
+            for (int l = 0; l < c.size(); l++) {
+                touch(c[l]);
+            }
+            remove_clause(crs[i]);
+            _subsumption_removed.push(crs[i]);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * eliminate_blocked_clause : (cr : CRARef) (effort : int64_t&) -> [bool]
+ * 
+ * Description:
+ *  Remove the problem clause 'cr' if it is blocked [JBH10]: for one of its 
+ *  literals 'l', every resolvent on 'l' is a tautology. With 
+ *  '_covered_elimination', the literals common to all the non-tautological
+ *  resolvents on a literal are added to the clause first (covered literal 
+ *  addition [HJB10]), until it is blocked or stops growing. The witness 'l'
+ *  must be on an eliminable variable. The record keeps the extended clause 
+ *  and then each clause it was extended from, with the literal it was 
+ *  extended on first: 'extend_model' makes each one true in this order. 
+ *  Every clause tried takes one from 'effort'. Returns true if the clause 
+ *  was removed.
+ * 
+ * Reference:
+ * [JBH10] M. Järvisalo, A. Biere, M. Heule. "Blocked Clause Elimination", 
+ * TACAS, 2010
+ * [HJB10] M. Heule, M. Järvisalo, A. Biere. "Covered Clause Elimination", 
+ * LPAR short paper, 2010
+ */
+bool Solver::eliminate_blocked_clause(CRARef cr, int64_t& effort) {
+    const Clause& c = _ca[cr];
+    Vector<Literal>& lits = _cover_literals;
+    lits.clear();
+    for (int i = 0; i < c.size(); i++) {
+        if (value(c[i]) != LIFTED_BOOLEAN_UNDEF) { return false; }
+        lits.push(c[i]);
+    }
+
+    // '_seen': 1 - in the clause positively, 2 - negatively
+    for (int i = 0; i < lits.size(); i++) {
+        _seen[lits[i].variable()] = 1 + lits[i].sign();
+    }
+
+    // '_cover_steps': size of the clause and index of the literal, for each
+    // covered literal addition
+    _cover_steps.clear();
+    int witness = -1;
+    for (bool grown = true; grown && witness < 0;) {
+        grown = false;
+        for (int k = 0; k < lits.size() && witness < 0 && effort > 0; k++) {
+            Literal l = lits[k];
+            const Vector<CRARef>& ds = _occur_lit[~l];
+            if (!is_eliminable(l.variable()) || ds.size() > _elim_occurence_limit) { continue; }
+
+            bool first = true;
+            _cover_common.clear();
+            int j = 0;
+            for (; j < ds.size(); j++) {
+                if (is_removed(ds[j])) { continue; }
+                effort--;
+
+                const Clause& d = _ca[ds[j]];
+                int t = 0;
+                for (; t < d.size(); t++) {
+                    Variable y = d[t].variable();
+                    if (y != l.variable() && _seen[y] != 0 && _seen[y] != 1 + d[t].sign()) { break; }
+                }
+                if (t < d.size()) { continue; }
+
+                // A non-tautological resolvent
+                if (!_covered_elimination) { break; }
+                if (first) {
+                    first = false;
+                    for (t = 0; t < d.size(); t++) {
+                        if (_seen[d[t].variable()] == 0) { _cover_common.push(d[t]); }
+                    }
+                } else {
+                    int a, b;
+                    for (a = b = 0; a < _cover_common.size(); a++) {
+                        if (find(d, _cover_common[a])) { _cover_common[b++] = _cover_common[a]; }
+                    }
+                    _cover_common.shrink(a - b);
+                }
+                if (_cover_common.size() == 0) { break; }
+            }
+
+            if (j < ds.size()) { continue; }
+            if (first) {
+                witness = k;
+            } else if (lits.size() + _cover_common.size() <= _cover_limit) {
+                _cover_steps.push(lits.size());
+                _cover_steps.push(k);
+                for (int a = 0; a < _cover_common.size(); a++) {
+                    _seen[_cover_common[a].variable()] = 1 + _cover_common[a].sign();
+                    lits.push(_cover_common[a]);
+                }
+                grown = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < lits.size(); i++) {
+        _seen[lits[i].variable()] = 0;
+    }
+    if (witness < 0) { return false; }
+
+    // The extended clause first, the clause itself last
+    int begin = _elim_clauses.size();
+    for (int step = _cover_steps.size(); step >= 0; step -= 2) {
+        int size = step == _cover_steps.size() ? lits.size() : _cover_steps[step];
+        int w = step == _cover_steps.size() ? witness : _cover_steps[step + 1];
+        _elim_clauses.push(size);
+        _elim_clauses.push(lits[w].to_int());
+        for (int i = 0; i < size; i++) {
+            if (i != w) { _elim_clauses.push(lits[i].to_int()); }
+        }
+        _witness[lits[w].variable()]++;
+    }
+    _elim_records.push(_Elimination(lits[witness].variable(), begin, _elim_clauses.size(), true));
+    _n_blocked++;
+    if (_cover_steps.size() > 0) { _n_covered++; }
+
+    for (int i = 0; i < c.size(); i++) {
+        touch(c[i]);
+    }
+    remove_clause(cr);
+    _subsumption_removed.push(cr);
+    return true;
+}
+
+/**
+ * eliminate_blocked : (effort : int64_t&) -> [void]
+ * 
+ * Description:
+ *  Remove the blocked problem clauses ('eliminate_blocked_clause') with a 
+ *  variable in '_elim_touched_list', until 'effort' runs out.
+ */
+void Solver::eliminate_blocked(int64_t& effort) {
+    if (!_blocked_elimination) { return; }
+
+    for (int i = 0; i < _clauses.size() && effort > 0; i++) {
+        CRARef cr = _clauses[i];
+        if (is_removed(cr)) { continue; }
+
+        const Clause& c = _ca[cr];
+        int k = 0;
+        for (; k < c.size() && !_elim_touched[c[k].variable()]; k++) {}
+        if (k < c.size()) { eliminate_blocked_clause(cr, effort); }
+    }
+}
+
+/**
+ * eliminate : (void) -> [bool]
+ * 
+ * Description:
+ *  Simplify the problem clauses by subsumption ('reduction_by_subsumption'),
+ *  blocked clause elimination ('eliminate_blocked') and bounded variable 
+ *  elimination, in rounds until no variable can be eliminated or 
+ *  '_elimination_effort' runs out. The candidates are the variables in 
+ *  '_elim_touched_list', fewest resolvents first. Frozen, non-decision and
+ *  assumed variables are never eliminated. Learnt clauses with an 
+ *  eliminated variable are removed. Returns false if the problem turned out
+ *  to be unsatisfiable.
+ */
+bool Solver::eliminate(void) {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::eliminate : we are not in the toplevel!");
+    }
+    // The rounds share one subsumption effort
+    int64_t subsumption_effort = _subsumption_effort;
+    if (!_elimination || !_myyura) { return reduction_by_subsumption(subsumption_effort); }
+
+    for (int i = 0; i < _assumptions.size(); i++) {
+        _frozen[_assumptions[i].variable()] |= 2;
+    }
+
+    int64_t effort = _elimination_effort;
+    int64_t blocked_effort = _blocked_effort;
+    uint64_t n_eliminated = _n_eliminated;
+    Vector<Variable> candidates;
+    Vector<uint64_t> keys;
+    bool ok = true;
+
+    for (; ok;) {
+        ok = reduction_by_subsumption(subsumption_effort);
+        if (!ok || effort <= 0 || _elim_touched_list.size() == 0) { break; }
+
+        // Fewer occurences for the variable elimination
+        eliminate_blocked(blocked_effort);
+
+        // Fewest resolvents (at most) first
+        keys.clear();
+        for (int i = 0; i < _elim_touched_list.size(); i++) {
+            Variable x = _elim_touched_list[i];
+            _elim_touched[x] = 0;
+            if (is_eliminable(x)) {
+                uint64_t cost = (uint64_t)_occur_lit[Literal(x)].size() * _occur_lit[~Literal(x)].size();
+                keys.push((std::min(cost, (uint64_t)UINT32_MAX) << 32) | (uint32_t)x);
+            }
+        }
+        _elim_touched_list.clear();
+        std::sort(keys.begin(), keys.end());
+        candidates.clear();
+        for (int i = 0; i < keys.size(); i++) {
+            candidates.push((Variable)(uint32_t)keys[i]);
+        }
+
+        uint64_t n_round = _n_eliminated;
+        int i = 0;
+        for (; i < candidates.size() && effort > 0 && ok; i++) {
+            if (is_eliminable(candidates[i])) {
+                ok = eliminate_variable(candidates[i], effort);
+            }
+        }
+
+        // Out of effort, the rest waits for the next call
+        for (; i < candidates.size(); i++) {
+            if (!_elim_touched[candidates[i]]) {
+                _elim_touched[candidates[i]] = 1;
+                _elim_touched_list.push(candidates[i]);
+            }
+        }
+
+        if (_n_eliminated == n_round) { break; }
+    }
+
+    for (int i = 0; i < _assumptions.size(); i++) {
+        _frozen[_assumptions[i].variable()] &= ~2;
+    }
+    if (!ok) { return false; }
+
+    if (_n_eliminated > n_eliminated) {
+        int i, j;
+        for (i = j = 0; i < _learnts.size(); i++) {
+            const Clause& c = _ca[_learnts[i]];
+            int k = 0;
+            for (; k < c.size() && _eliminated[c[k].variable()] < 0; k++) {}
+
+            if (k < c.size()) {
+                remove_clause(_learnts[i]);
+            } else {
+                _learnts[j++] = _learnts[i];
+            }
+        }
+        _learnts.shrink(i - j);
+    }
+
+    for (int i = 0; i < _subsumption_removed.size(); i++) {
+        const Clause& c = _ca[_subsumption_removed[i]];
+        for (int k = 0; k < c.size(); k++) {
+            _occur_lit.smudge(c[k]);
+        }
+    }
+    _subsumption_removed.clear();
+    _occur_lit.clean_all();
+
+    check_garbage();
+    return true;
+}
+
+/**
+ * restore_variable : (x : Variable) -> [void]
+ * 
+ * Description:
+ *  Put the clauses removed by the elimination of 'x' back (and before them 
+ *  the ones of the variables eliminated later that they contain), 'x' is a 
+ *  decision variable again. The resolvents stay, they are implied. The 
+ *  blocked clauses with a witness on 'x' are put back too 
+ *  ('restore_blocked').
+ */
+void Solver::restore_variable(Variable x) {
+    if (_proof != NULL) {
+        throw std::logic_error("Solver::restore_variable : can't restore an eliminated variable while writing a proof");
+    }
+
+    if (_witness[x] > 0) { restore_blocked(x); }
+
+    if (_eliminated[x] >= 0) {
+        // A copy, the restores below may drop the record
+        int r = _eliminated[x];
+        Vector<uint32_t> cs;
+        for (int i = _elim_records[r].begin; i < _elim_records[r].end; i++) {
+            cs.push(_elim_clauses[i]);
+        }
+        _elim_records[r].x = VARIABLE_UNDEF;
+        _eliminated[x] = -1;
+        decision(x, true);
+
+        for (int i = 0; i < cs.size(); i++) {
+            int n = cs[i];
+            for (int k = 1; k <= n; k++) {
+                Variable y = cs[i + k] >> 1;
+                if (is_extended(y)) { restore_variable(y); }
+            }
+            i += n;
+        }
+
+        Vector<Literal> ps;
+        for (int i = 0; i < cs.size() && _myyura; i++) {
+            int n = cs[i];
+            ps.clear();
+            for (int k = 1; k <= n; k++) {
+                ps.push(Literal(cs[i + k] >> 1, cs[i + k] & 1));
+            }
+            add_resolvent(ps, 0, 0);
+            i += n;
+        }
+    }
+
+    // Records at the end that are not used any more
+    for (; _elim_records.size() > 0 && _elim_records.back().x == VARIABLE_UNDEF;) {
+        _elim_clauses.shrink(_elim_clauses.size() - _elim_records.back().begin);
+        _elim_records.pop();
+    }
+}
+
+/**
+ * restore_blocked : (x : Variable) -> [void]
+ * 
+ * Description:
+ *  Put the blocked clauses back whose record has a witness on 'x', a new 
+ *  clause or assumption on 'x' could make them wrong. The variables in a 
+ *  clause that are eliminated, or witnesses of blocked clauses removed 
+ *  later, are restored first.
+ */
+void Solver::restore_blocked(Variable x) {
+    Vector<Literal> ps;
+
+    for (int r = 0; r < _elim_records.size() && _witness[x] > 0 && _myyura; r++) {
+        if (!_elim_records[r].blocked || _elim_records[r].x == VARIABLE_UNDEF) { continue; }
+
+        int begin = _elim_records[r].begin, end = _elim_records[r].end;
+        int last = -1;
+        for (int i = begin; i < end; i += _elim_clauses[i] + 1) {
+            if ((Variable)(_elim_clauses[i + 1] >> 1) == x) { last = i; }
+        }
+        if (last < 0) { continue; }
+
+        // The clause removed is the last one of the record
+        for (int i = begin; i < end; i += _elim_clauses[i] + 1) {
+            _witness[_elim_clauses[i + 1] >> 1]--;
+            last = i;
+        }
+        _elim_records[r].x = VARIABLE_UNDEF;
+
+        int n = _elim_clauses[last];
+        ps.clear();
+        for (int k = 1; k <= n; k++) {
+            ps.push(Literal(_elim_clauses[last + k] >> 1, _elim_clauses[last + k] & 1));
+        }
+        for (int k = 0; k < ps.size(); k++) {
+            if (is_extended(ps[k].variable())) { restore_variable(ps[k].variable()); }
+        }
+        if (_myyura) { add_resolvent(ps, 0, 0); }
+    }
+}
+
+/**
+ * extend_model : (void) -> [void]
+ * 
+ * Description:
+ *  Give the eliminated variables a value in '_model_value', the last one 
+ *  eliminated first: true if a clause with the positive literal would be 
+ *  false otherwise, false if not. A removed blocked clause that is false 
+ *  flips its witness.
+ */
+void Solver::extend_model(void) {
+    for (int r = _elim_records.size() - 1; r >= 0; r--) {
+        Variable x = _elim_records[r].x;
+        if (x == VARIABLE_UNDEF) { continue; }
+
+        // Each clause of a blocked record in turn, a false one is made true 
+        // by its witness
+        if (_elim_records[r].blocked) {
+            for (int i = _elim_records[r].begin; i < _elim_records[r].end; i += _elim_clauses[i] + 1) {
+                int n = _elim_clauses[i];
+                bool satisfied = false;
+                for (int k = 1; k <= n && !satisfied; k++) {
+                    Literal p(_elim_clauses[i + k] >> 1, _elim_clauses[i + k] & 1);
+                    satisfied = model_value(p) == LIFTED_BOOLEAN_TRUE;
+                }
+                if (!satisfied) {
+                    Literal w(_elim_clauses[i + 1] >> 1, _elim_clauses[i + 1] & 1);
+                    _model_value[w.variable()] = LIFTED_BOOLEAN_TRUE ^ w.sign();
+                }
+            }
+            continue;
+        }
+
+        LiftedBoolean v = LIFTED_BOOLEAN_FALSE;
+        for (int i = _elim_records[r].begin; i < _elim_records[r].end && v == LIFTED_BOOLEAN_FALSE; i++) {
+            int n = _elim_clauses[i];
+            bool positive = false, satisfied = false;
+            for (int k = 1; k <= n; k++) {
+                Literal p(_elim_clauses[i + k] >> 1, _elim_clauses[i + k] & 1);
+                if (p == Literal(x)) {
+                    positive = true;
+                } else if (model_value(p) == LIFTED_BOOLEAN_TRUE) {
+                    satisfied = true;
+                }
+            }
+            if (positive && !satisfied) { v = LIFTED_BOOLEAN_TRUE; }
+            i += n;
+        }
+
+        _model_value[x] = v;
+    }
+}
+
+// Backtrack to the top level without changing the saved phases, after a 
+// probe or vivification
+void Solver::cancel_keeping_phases(void) {
+    // The saved phase of each variable as a literal, like 'cancel_until' 
+    // saves it
+    _probe_phases.clear();
+    for (int t = _trail_lim[0]; t < _trail.size(); t++) {
+        Variable x = _trail[t].variable();
+        _probe_phases.push(Literal(x, !_polarity[x]));
+    }
+    cancel_until(0);
+    for (int t = 0; t < _probe_phases.size(); t++) {
+        _polarity[_probe_phases[t].variable()] = !_probe_phases[t].sign();
+    }
+}
+
+/**
+ * hyper_binary_resolution : (implied : Vector<int>&) (epoch : int) -> [void]
+ * 
+ * Description:
+ *  Helper of 'probe', after the probe at level 1 propagated without a 
+ *  conflict. Walks the level 1 trail and builds the binary implication tree 
+ *  of the probe in '_probe_parent' and '_probe_depth'. A literal implied by a
+ *  longer clause hangs from the dominator of the clause's false literals and
+ *  gets the binary clause (dominator -> literal) as its new reason, learnt 
+ *  unless it is there already. Marks the literals in 'implied' with 'epoch'.
+ */
+void Solver::hyper_binary_resolution(Vector<int>& implied, int epoch) {
+    Literal p = _trail[_trail_lim[0]];
+    _probe_parent[p] = LITERAL_UNDEF;
+    _probe_depth[p.variable()] = 0;
+
+    Vector<Literal> ps;
+    for (int t = _trail_lim[0] + 1; t < _trail.size(); t++) {
+        Literal q = _trail[t];
+        implied[q.to_int()] = epoch;
+
+        const Clause& c = _ca[reason_clause(q.variable())];
+        if (c.size() == 2) {
+            _probe_parent[q] = c[0] == q ? ~c[1] : ~c[0];
+            _probe_depth[q.variable()] = _probe_depth[_probe_parent[q].variable()] + 1;
+            continue;
+        }
+
+        // Dominator of the false literals of 'c' at level 1
+        Literal d = LITERAL_UNDEF;
+        for (int k = 0; k < c.size(); k++) {
+            Literal r = ~c[k];
+            if (c[k] == q || level(r.variable()) == 0) { continue; }
+            if (d == LITERAL_UNDEF) { 
+                d = r;
+                continue; 
+            }
+
+            for (; _probe_depth[r.variable()] > _probe_depth[d.variable()];) { r = _probe_parent[r]; }
+            for (; _probe_depth[d.variable()] > _probe_depth[r.variable()];) { d = _probe_parent[d]; }
+            for (; r != d;) {
+                r = _probe_parent[r];
+                d = _probe_parent[d];
+            }
+        }
+
+        _probe_parent[q] = d;
+        _probe_depth[q.variable()] = _probe_depth[d.variable()] + 1;
+
+        // The binary clause may be there already
+        const Vector<_Watcher>& ws = _watches[d];
+        int k = 0;
+        for (; k < ws.size() && !(ws[k].binary && ws[k].blocker == q); k++) {}
+        if (k < ws.size()) {
+            _variable_info[q.variable()].reason = ws[k].cref;
+            continue;
+        }
+
+        ps.clear();
+        ps.push(q);
+        ps.push(~d);
+        uint64_t id = 0;
+        if (_proof != NULL) {
+            id = new_clause_id();
+            _proof_hints.clear();
+            if (lrat()) { proof_chain(reason(q.variable()), ps); }
+            proof_add(ps, 2, id);
+        }
+
+        CRARef cr = _ca.alloc(ps, true);
+        if (_ca.clause_ids()) { _ca[cr].id(id); }
+        // Kept like core clauses, binary clauses are cheap to propagate
+        _ca[cr].lbd(_core_lbd);
+        _learnts.push(cr);
+        attach_clause_watcher(cr);
+        _variable_info[q.variable()].reason = cr;
+        _n_hyper_binaries++;
+    }
+}
+
+/**
+ * probe : (ticks : uint64_t) -> [bool]
+ * 
+ * Description:
+ *  Failed literal probing with lazy hyper-binary resolution. The candidates
+ *  are the roots of the binary implication graph (literals that imply others
+ *  by binary clauses but are implied by none), taken in turns from 
+ *  '_probe_next'. Each one is assigned at decision level 1 and propagated:
+ *   - on a conflict it failed, its negation is learnt as a unit
+ *   - otherwise every literal implied by a longer clause gets a learnt binary
+ *     clause from the dominator of the clause's false literals (the closest
+ *     literal implying all of them by binary clauses), which becomes its 
+ *     reason. Later literals are then resolved over binary reasons only.
+ *  Literals implied at level 1 are not probed again in the same round until a
+ *  unit is learnt. Stops after 'ticks' propagations. Returns false if the 
+ *  problem turned out to be unsatisfiable.
+ */
+bool Solver::probe(uint64_t ticks) {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::probe : we are not in the toplevel!");
+    }
+
+    CRARef conflict = propagate();
+    if (conflict != CRAREF_UNDEF) {
+        if (_proof != NULL) { proof_empty_clause(conflict); }
+        return _myyura = false;
+    }
+    if (lrat()) { proof_units(); }
+
+    _watches.clean_all();
+
+    // Roots of the binary implication graph, from '_probe_next' on
+    int n_literals = 2 * n_variables();
+    if (_probe_next >= n_literals) { _probe_next = 0; }
+    Vector<Literal> candidates;
+    for (int i = 0; i < n_literals; i++) {
+        int index = _probe_next + i < n_literals ? _probe_next + i : _probe_next + i - n_literals;
+        Literal p = Literal(index >> 1, index & 1);
+        if (value(p) != LIFTED_BOOLEAN_UNDEF || !_decision[p.variable()]) { continue; }
+
+        bool out = false, in = false;
+        const Vector<_Watcher>& ws = _watches[p];
+        for (int k = 0; k < ws.size() && !out; k++) { out = ws[k].binary; }
+        const Vector<_Watcher>& vs = _watches[~p];
+        for (int k = 0; k < vs.size() && !in; k++) { in = vs[k].binary; }
+
+        if (out && !in) { candidates.push(p); }
+    }
+    if (candidates.size() == 0) { return true; }
+
+    // 'implied[p] == epoch' - 'p' was true under an earlier probe of this round
+    Vector<int> implied;
+    implied.grow_to(n_literals, -1);
+    int epoch = 0;
+
+    _probe_parent.reserve(Literal(n_variables() - 1, true), LITERAL_UNDEF);
+    _probe_depth.reserve(n_variables() - 1, 0);
+
+    Vector<Literal> ps;
+    uint64_t limit = _n_propagations + ticks;
+    int i = 0;
+
+    for (; i < candidates.size() && _n_propagations < limit && within_budget(); i++) {
+        Literal p = candidates[i];
+        if (value(p) != LIFTED_BOOLEAN_UNDEF || implied[p.to_int()] == epoch) { continue; }
+
+        new_decision_level();
+        unchecked_enqueue(p);
+        conflict = propagate();
+
+        uint64_t id = 0;
+        if (conflict != CRAREF_UNDEF) {
+            // 'p' failed
+            ps.clear();
+            ps.push(~p);
+            if (_proof != NULL) {
+                id = new_clause_id();
+                _proof_hints.clear();
+                if (lrat()) { proof_chain(conflict, ps); }
+                proof_add(ps, 1, id);
+            }
+        } else {
+            hyper_binary_resolution(implied, epoch);
+        }
+
+        cancel_keeping_phases();
+
+        if (conflict != CRAREF_UNDEF) {
+            unchecked_enqueue(~p);
+            if (_proof != NULL) { _unit_id[p.variable()] = id; }
+            _n_failed_literals++;
+            epoch++;
+
+            conflict = propagate();
+            if (conflict != CRAREF_UNDEF) {
+                if (_proof != NULL) { proof_empty_clause(conflict); }
+                return _myyura = false;
+            }
+            if (lrat()) { proof_units(); }
+        }
+    }
+
+    // The next round starts with the first candidate not probed
+    if (i < candidates.size()) { _probe_next = candidates[i].to_int(); }
+
+    check_garbage();
+    return true;
+}
+
+/**
+ * binary_components : (component : Vector<int>&) (members : Vector<Literal>&) (begins : Vector<int>&) -> [void]
+ * 
+ * Description:
+ *  Strongly connected components of the binary implication graph over the 
+ *  unassigned literals of the decision variables, by Tarjan's algorithm with
+ *  an explicit stack. 'component[p]' is the component of literal 'p' (-1 if 
+ *  it is not in the graph), the components with more than one literal are 
+ *  listed in 'members' from 'begins[i]' to 'begins[i + 1]'. A component is
+ *  found after every component it implies, its dual (the negated literals)
+ *  may come before or after it.
+ */
+void Solver::binary_components(Vector<int>& component, Vector<Literal>& members, Vector<int>& begins) {
+    int n_literals = 2 * n_variables();
+    Vector<int> index(n_literals, -1), low(n_literals, 0);
+    component.clear();
+    component.grow_to(n_literals, -1);
+    members.clear();
+    begins.clear();
+    begins.push(0);
+
+    // 'dfs': literal and the next watcher to follow, 'stack': Tarjan's stack
+    struct _DfsFrame {
+        Literal p;
+        int watcher;
+    };
+    Vector<_DfsFrame> dfs;
+    Vector<Literal> stack;
+    int counter = 0, n_components = 0;
+
+    auto in_graph = [&](Literal p) -> bool {
+        return value(p) == LIFTED_BOOLEAN_UNDEF && _decision[p.variable()];
+    };
+
+    for (int s = 0; s < n_literals; s++) {
+        Literal root = Literal(s >> 1, s & 1);
+        if (index[s] >= 0 || !in_graph(root)) { continue; }
+
+        index[s] = low[s] = counter++;
+        stack.push(root);
+        dfs.push({ root, 0 });
+
+        for (; dfs.size() > 0;) {
+            Literal p = dfs.back().p;
+            const Vector<_Watcher>& ws = _watches[p];
+            int k = dfs.back().watcher;
+            Literal next = LITERAL_UNDEF;
+
+            for (; k < ws.size(); k++) {
+                Literal q = ws[k].blocker;
+                if (!ws[k].binary || !in_graph(q)) { continue; }
+
+                if (index[q.to_int()] < 0) {
+                    next = q;
+                    k++;
+                    break;
+                } else if (component[q.to_int()] < 0) {
+                    low[p.to_int()] = std::min(low[p.to_int()], index[q.to_int()]);
+                }
+            }
+            dfs.back().watcher = k;
+
+            if (next != LITERAL_UNDEF) {
+                index[next.to_int()] = low[next.to_int()] = counter++;
+                stack.push(next);
+                dfs.push({ next, 0 });
+                continue;
+            }
+
+            dfs.pop();
+            if (dfs.size() > 0) {
+                int parent = dfs.back().p.to_int();
+                low[parent] = std::min(low[parent], low[p.to_int()]);
+            }
+
+            if (low[p.to_int()] == index[p.to_int()]) {
+                int size = 0;
+                Literal q;
+                do {
+                    q = stack.back();
+                    stack.pop();
+                    component[q.to_int()] = n_components;
+                    members.push(q);
+                    size++;
+                } while (q != p);
+
+                // Single literals are not listed
+                if (size == 1) {
+                    members.pop();
+                } else {
+                    begins.push(members.size());
+                }
+                n_components++;
+            }
+        }
+    }
+}
+
+/**
+ * substitute : (void) -> [bool]
+ * 
+ * Description:
+ *  Equivalent literal substitution. The literals of a strongly connected 
+ *  component of the binary implication graph are all equivalent, each one is
+ *  replaced by a representative (a frozen literal if there is one, otherwise
+ *  the one with the smallest variable) in every problem and learnt clause. A
+ *  component with both a literal and its negation makes the problem 
+ *  unsatisfiable. The replaced variables are kept with an elimination record
+ *  of the two binary clauses of the equivalence, so 'extend_model' gives them
+ *  the value of their representative. In the proof the equivalences are 
+ *  derived along the implication paths found by a breadth-first search from
+ *  the representative, and deleted after the clauses are rewritten. Returns
+ *  false if the problem turned out to be unsatisfiable.
+ */
+bool Solver::substitute(void) {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::substitute : we are not in the toplevel!");
+    }
+    if (!_myyura) { return false; }
+    if (!_elimination) { return true; }
+
+    CRARef conflict = propagate();
+    if (conflict != CRAREF_UNDEF) {
+        if (_proof != NULL) { proof_empty_clause(conflict); }
+        return _myyura = false;
+    }
+    if (lrat()) { proof_units(); }
+
+    _watches.clean_all();
+
+    Vector<int> component, begins;
+    Vector<Literal> members;
+    binary_components(component, members, begins);
+    if (members.size() == 0) { return true; }
+
+    for (int i = 0; i < _assumptions.size(); i++) {
+        _frozen[_assumptions[i].variable()] |= 2;
+    }
+
+    // 'repr[p]' - the literal replacing 'p', 'equivalence[p]' - the proof id
+    // of the clause (~p | repr[p])
+    int n_literals = 2 * n_variables();
+    Vector<Literal> repr(n_literals, LITERAL_UNDEF);
+    Vector<uint64_t> equivalence(n_literals, 0);
+    Vector<Literal> parent(n_literals, LITERAL_UNDEF);
+    Vector<uint64_t> parent_id(n_literals, 0);
+    Vector<Literal> queue, ps;
+    Vector<Variable> substituted;
+    bool ok = true;
+
+    // Breadth-first search in the component of 'r' from it, 'parent' and 
+    // 'parent_id' are the tree edges (and the clauses implying them)
+    auto search = [&](Literal r) {
+        queue.clear();
+        queue.push(r);
+        parent[r.to_int()] = r;
+        for (int head = 0; head < queue.size(); head++) {
+            Literal p = queue[head];
+            const Vector<_Watcher>& ws = _watches[p];
+            for (int k = 0; k < ws.size(); k++) {
+                Literal q = ws[k].blocker;
+                if (!ws[k].binary || value(q) != LIFTED_BOOLEAN_UNDEF
+                    || component[q.to_int()] != component[r.to_int()] || parent[q.to_int()] != LITERAL_UNDEF) { 
+                    continue; 
+                }
+                parent[q.to_int()] = p;
+                parent_id[q.to_int()] = _ca.clause_ids() ? _ca[ws[k].cref].id() : 0;
+                queue.push(q);
+            }
+        }
+    };
+
+    // The clause (~t | q) for 'q' in the tree of 't', the hints follow the 
+    // path from 't' to 'q'
+    auto derive = [&](Literal t, Literal q) -> uint64_t {
+        _proof_hints.clear();
+        if (lrat()) {
+            for (Literal p = q; p != t; p = parent[p.to_int()]) {
+                _proof_chain.push(parent_id[p.to_int()]);
+            }
+            for (int i = _proof_chain.size() - 1; i >= 0; i--) {
+                _proof_hints.push(_proof_chain[i]);
+            }
+            _proof_chain.clear();
+        }
+        ps.clear();
+        ps.push(~t);
+        if (q != ~t) { ps.push(q); }
+        uint64_t id = new_clause_id();
+        proof_add(ps, ps.size(), id);
+        return id;
+    };
+
+    for (int c = 0; c + 1 < begins.size() && ok; c++) {
+        Literal first = members[begins[c]];
+        if (repr[first.to_int()] != LITERAL_UNDEF) { continue; }
+
+        // The dual component was done first
+        if (repr[(~first).to_int()] != LITERAL_UNDEF) {
+            for (int i = begins[c]; i < begins[c + 1]; i++) {
+                Literal p = members[i];
+                repr[p.to_int()] = ~repr[(~p).to_int()];
+            }
+            continue;
+        }
+
+        Literal r = first;
+        for (int i = begins[c]; i < begins[c + 1]; i++) {
+            Literal p = members[i];
+            bool frozen = _frozen[p.variable()] != 0, r_frozen = _frozen[r.variable()] != 0;
+            if ((frozen && !r_frozen) || (frozen == r_frozen && p.variable() < r.variable())) { r = p; }
+        }
+
+        if (component[(~r).to_int()] == component[r.to_int()]) {
+            // 'r' implies '~r' and the other way round
+            if (lrat()) { search(r); }
+            uint64_t id = _proof != NULL ? derive(r, ~r) : 0;
+            unchecked_enqueue(~r);
+            if (_proof != NULL) { _unit_id[r.variable()] = id; }
+            conflict = propagate();
+            if (_proof != NULL) { proof_empty_clause(conflict); }
+            ok = _myyura = false;
+            break;
+        }
+
+        if (lrat()) {
+            search(r);
+            search(~r);
+        }
+
+        for (int i = begins[c]; i < begins[c + 1]; i++) {
+            Literal p = members[i];
+            repr[p.to_int()] = r;
+            if (p == r || !is_eliminable(p.variable())) {
+                repr[p.to_int()] = p;
+                continue;
+            }
+
+            // (~p | r) as '~r' implies '~p', and (p | ~r)
+            if (_proof != NULL) {
+                equivalence[p.to_int()] = derive(~r, ~p);
+                equivalence[(~p).to_int()] = derive(r, p);
+            }
+
+            // The model gets the value of 'r' for 'p'
+            Variable x = p.variable();
+            int begin = _elim_clauses.size();
+            _elim_clauses.push(2);
+            _elim_clauses.push(p.to_int());
+            _elim_clauses.push((~r).to_int());
+            _elim_clauses.push(2);
+            _elim_clauses.push((~p).to_int());
+            _elim_clauses.push(r.to_int());
+            _eliminated[x] = _elim_records.size();
+            _elim_records.push(_Elimination(x, begin, _elim_clauses.size()));
+            decision(x, false);
+            substituted.push(x);
+            _n_substituted++;
+        }
+    }
+
+    for (int i = 0; i < _assumptions.size(); i++) {
+        _frozen[_assumptions[i].variable()] &= ~2;
+    }
+    if (!ok) { return false; }
+
+    // Rewrite the clauses with a replaced literal
+    for (int k = 0; k < 2 && ok; k++) {
+        Vector<CRARef>& cs = k == 0 ? _clauses : _learnts;
+        int n = cs.size();
+        for (int i = 0; i < n && ok; i++) {
+            CRARef cr = cs[i];
+            if (is_removed(cr)) { continue; }
+
+            const Clause& c = _ca[cr];
+            int l = 0;
+            for (; l < c.size() && (repr[c[l].to_int()] == LITERAL_UNDEF || repr[c[l].to_int()] == c[l]); l++) {}
+            if (l == c.size()) { continue; }
+
+            ps.clear();
+            bool satisfied = false;
+            for (l = 0; l < c.size(); l++) {
+                Literal p = repr[c[l].to_int()] == LITERAL_UNDEF ? c[l] : repr[c[l].to_int()];
+                if (is_true(p)) { satisfied = true; }
+                ps.push(p);
+            }
+            std::sort(ps.begin(), ps.end());
+            int a, b;
+            for (a = b = 0; a < ps.size() && !satisfied; a++) {
+                if (b > 0 && ps[a] == ~ps[b - 1]) {
+                    satisfied = true;
+                } else if ((b == 0 || ps[a] != ps[b - 1]) && !is_false(ps[a])) {
+                    ps[b++] = ps[a];
+                }
+            }
+            ps.shrink(a - b);
+
+            uint64_t id = 0;
+            if (!satisfied && _proof != NULL) {
+                _proof_hints.clear();
+                if (lrat()) {
+                    for (l = 0; l < c.size(); l++) {
+                        Literal p = repr[c[l].to_int()] == LITERAL_UNDEF ? c[l] : repr[c[l].to_int()];
+                        if (is_false(p) && !_seen[p.variable()]) { 
+                            _seen[p.variable()] = 1;
+                            _proof_hints.push(_unit_id[p.variable()]); 
+                        }
+                    }
+                    for (l = 0; l < c.size(); l++) {
+                        Literal p = repr[c[l].to_int()] == LITERAL_UNDEF ? c[l] : repr[c[l].to_int()];
+                        _seen[p.variable()] = 0;
+                    }
+                    for (l = 0; l < c.size(); l++) {
+                        if (equivalence[c[l].to_int()] != 0) { _proof_hints.push(equivalence[c[l].to_int()]); }
+                    }
+                    _proof_hints.push(c.id());
+                }
+                id = new_clause_id();
+                proof_add(ps, ps.size(), id);
+            }
+
+            bool learnt = c.learnt();
+            uint32_t lbd = learnt ? c.lbd() : 0;
+            for (l = 0; l < c.size() && !learnt; l++) {
+                touch(c[l]);
+                _occur_lit.smudge(c[l]);
+            }
+            remove_clause(cr);
+            if (satisfied) { continue; }
+
+            if (ps.size() == 0) {
+                ok = _myyura = false;
+            } else if (ps.size() == 1) {
+                unchecked_enqueue(ps[0]);
+                if (_proof != NULL) { _unit_id[ps[0].variable()] = id; }
+                conflict = propagate();
+                if (conflict != CRAREF_UNDEF) {
+                    if (_proof != NULL) { proof_empty_clause(conflict); }
+                    ok = _myyura = false;
+                } else if (lrat()) {
+                    proof_units();
+                }
+            } else {
+                CRARef nr = _ca.alloc(ps, learnt);
+                if (_ca.clause_ids()) { _ca[nr].id(id); }
+                if (learnt) {
+                    _ca[nr].lbd(std::min(lbd, (uint32_t)ps.size()));
+                    _learnts.push(nr);
+                } else {
+                    _clauses.push(nr);
+                    attach_clause_occlit(nr);
+                }
+                attach_clause_watcher(nr);
+            }
+        }
+    }
+
+    int i, j;
+    for (i = j = 0; i < _learnts.size(); i++) {
+        if (!is_removed(_learnts[i])) { _learnts[j++] = _learnts[i]; }
+    }
+    _learnts.shrink(i - j);
+    _occur_lit.clean_all();
+
+    // The equivalences are not needed any more
+    if (_proof != NULL) {
+        for (int k = 0; k < substituted.size(); k++) {
+            for (int sign = 0; sign < 2; sign++) {
+                Literal p = Literal(substituted[k], sign);
+                ps.clear();
+                ps.push(~p);
+                ps.push(repr[p.to_int()]);
+                _proof->remove(ps, 2, equivalence[p.to_int()]);
+            }
+        }
+    }
+
+    check_garbage();
+    return ok;
+}
+
+/**
+ * vivify_clause : (cr : CRARef) -> [bool]
+ * 
+ * Description:
+ *  Helper of 'vivify'. The negations of the literals of clause 'cr' are 
+ *  assigned one at a time at new decision levels and propagated, until there
+ *  is a conflict or a literal of the clause is implied true. The decisions 
+ *  that led there (walking the reasons back), with the implied literal, form
+ *  a clause implied by the clause set. If it is shorter it replaces 'cr', 
+ *  which drops the literals implied false and the decisions that were not 
+ *  needed. Returns false if the problem turned out to be unsatisfiable.
+ */
+bool Solver::vivify_clause(CRARef cr) {
+    // 'propagate' may reorder the clause (and move it, the XOR matrices 
+    // allocate their reasons)
+    Vector<Literal>& lits = _vivify_literals;
+    lits.clear();
+    for (int i = 0; i < _ca[cr].size(); i++) {
+        if (is_true(_ca[cr][i])) { return true; }
+        lits.push(_ca[cr][i]);
+    }
+
+    CRARef conflict = CRAREF_UNDEF;
+    Literal implied = LITERAL_UNDEF;
+    for (int i = 0; i < lits.size() && conflict == CRAREF_UNDEF; i++) {
+        if (is_true(lits[i])) {
+            implied = lits[i];
+            break;
+        } else if (!is_false(lits[i])) {
+            new_decision_level();
+            unchecked_enqueue(~lits[i]);
+            conflict = propagate();
+        }
+    }
+
+    // The decisions the conflict (or the implied literal) depends on
+    Vector<Literal>& ps = _add_clause_temp;
+    ps.clear();
+    _analyze_toclear.clear();
+    CRARef from = conflict;
+    if (implied != LITERAL_UNDEF) {
+        ps.push(implied);
+        _seen[implied.variable()] = 1;
+        _analyze_toclear.push(implied);
+        from = reason_clause(implied.variable());
+    }
+
+    int pending = 0;
+    for (int index = _trail.size() - 1; from != CRAREF_UNDEF || pending > 0; index--) {
+        if (from != CRAREF_UNDEF) {
+            const Clause& r = _ca[from];
+            for (int i = 0; i < r.size(); i++) {
+                Variable y = r[i].variable();
+                if (_seen[y] || level(y) == 0) { continue; }
+                _seen[y] = 1;
+                _analyze_toclear.push(r[i]);
+                pending++;
+            }
+        }
+
+        for (; !_seen[_trail[index].variable()] || _trail[index] == implied; index--) {}
+        Literal q = _trail[index];
+        pending--;
+        from = reason_clause(q.variable());
+        if (from == CRAREF_UNDEF) { ps.push(~q); }
+    }
+
+    for (int i = 0; i < _analyze_toclear.size(); i++) {
+        _seen[_analyze_toclear[i].variable()] = 0;
+    }
+
+    Clause& c = _ca[cr];
+    if (ps.size() >= c.size()) {
+        cancel_keeping_phases();
+        return true;
+    }
+
+    uint64_t id = 0;
+    if (_proof != NULL) {
+        id = new_clause_id();
+        _proof_hints.clear();
+        if (lrat()) { proof_chain(conflict != CRAREF_UNDEF ? conflict : reason(implied.variable()), ps); }
+        proof_add(ps, ps.size(), id);
+    }
+    cancel_keeping_phases();
+
+    _n_vivified++;
+    _n_vivified_literals += c.size() - ps.size();
+    bool learnt = c.learnt();
+
+    if (ps.size() == 1) {
+        for (int i = 0; i < c.size() && !learnt; i++) {
+            touch(c[i]);
+            _occur_lit.smudge(c[i]);
+        }
+        remove_clause(cr);
+
+        unchecked_enqueue(ps[0]);
+        if (_proof != NULL) { _unit_id[ps[0].variable()] = id; }
+        conflict = propagate();
+        if (conflict != CRAREF_UNDEF) {
+            if (_proof != NULL) { proof_empty_clause(conflict); }
+            return _myyura = false;
+        }
+        if (lrat()) { proof_units(); }
+        return true;
+    }
+
+    detach_clause_watcher(cr, true);
+    if (_proof != NULL) {
+        proof_remove(c);
+        if (c.has_id()) { c.id(id); }
+    }
+
+    // 'ps' is a subset of the clause
+    for (int i = 0; i < ps.size(); i++) { _seen[ps[i].variable()] = 1; }
+    for (int i = 0; i < c.size() && !learnt; i++) {
+        if (!_seen[c[i].variable()]) { remove(_occur_lit[c[i]], cr); }
+        touch(c[i]);
+    }
+    for (int i = 0; i < ps.size(); i++) { _seen[ps[i].variable()] = 0; }
+
+    int n = c.size();
+    for (int i = 0; i < ps.size(); i++) { c[i] = ps[i]; }
+    c.shrink(n - ps.size());
+
+    if (learnt) {
+        c.lbd(std::min(c.lbd(), (uint32_t)ps.size()));
+    } else {
+        if (c.has_extra()) { c.calc_abstraction(); }
+        _strengthened.insert(cr);
+    }
+    attach_clause_watcher(cr);
+
+    return true;
+}
+
+/**
+ * vivify : (ticks : uint64_t) -> [bool]
+ * 
+ * Description:
+ *  Clause vivification. The learnt clauses of tier2 that were not tried yet
+ *  go first, the lowest LBD first, then the core ones, with half of 'ticks'
+ *  propagations. The problem clauses are tried in turns from '_vivify_next'
+ *  with another quarter. Only clauses with more than two literals are tried,
+ *  see 'vivify_clause'. Returns false if the problem turned out to be 
+ *  unsatisfiable.
+ */
+bool Solver::vivify(uint64_t ticks) {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::vivify : we are not in the toplevel!");
+    }
+    if (!_myyura) { return false; }
+    if (!_vivification) { return true; }
+
+    CRARef conflict = propagate();
+    if (conflict != CRAREF_UNDEF) {
+        if (_proof != NULL) { proof_empty_clause(conflict); }
+        return _myyura = false;
+    }
+    if (lrat()) { proof_units(); }
+
+    Vector<CRARef> candidates;
+    for (int i = 0; i < _learnts.size(); i++) {
+        const Clause& c = _ca[_learnts[i]];
+        if (c.size() > 2 && c.lbd() <= _tier2_lbd && !c.vivified()) { candidates.push(_learnts[i]); }
+    }
+    const ClauseAllocator& ca = _ca;
+    uint32_t core_lbd = _core_lbd;
+    std::sort(candidates.begin(), candidates.end(), [&](CRARef x, CRARef y) -> bool {
+        bool x_core = ca[x].lbd() <= core_lbd, y_core = ca[y].lbd() <= core_lbd;
+        if (x_core != y_core) { return y_core; }
+        if (ca[x].lbd() != ca[y].lbd()) { return ca[x].lbd() < ca[y].lbd(); }
+        return ca[x].size() < ca[y].size();
+    });
+
+    bool ok = true;
+    uint64_t limit = _n_propagations + ticks / 2;
+    for (int i = 0; i < candidates.size() && ok && _n_propagations < limit && within_budget(); i++) {
+        if (is_removed(candidates[i])) { continue; }
+        _ca[candidates[i]].vivified(true);
+        ok = vivify_clause(candidates[i]);
+    }
+
+    limit = _n_propagations + ticks / 4;
+    int n = _clauses.size();
+    if (_vivify_next >= n) { _vivify_next = 0; }
+    for (int i = 0; i < n && ok && _n_propagations < limit && within_budget(); i++) {
+        CRARef cr = _clauses[_vivify_next];
+        _vivify_next = _vivify_next + 1 < n ? _vivify_next + 1 : 0;
+        if (is_removed(cr) || _ca[cr].size() <= 2) { continue; }
+        ok = vivify_clause(cr);
+    }
+
+    int i, j;
+    for (i = j = 0; i < _learnts.size(); i++) {
+        if (!is_removed(_learnts[i])) { _learnts[j++] = _learnts[i]; }
+    }
+    _learnts.shrink(i - j);
+
+    if (ok) { check_garbage(); }
+    return ok;
+}
+
+// Public
+
+/**
+ * simplify : (void) -> [bool]
+ * 
+ * Description:
+ *  Remove the learnt and problem clauses satisfied at the top level and the
+ *  false literals from the others ('toplevel_simplify_satisfied_clause'). 
+ *  Nothing is done unless the top level grew since the last call and there 
+ *  were as many propagations since as literals in the clauses it left. 
+ *  Returns false if the problem turned out to be unsatisfiable.
+ */
+bool Solver::simplify(void) {
+    if (decision_level() != 0) {
+        throw std::logic_error("Solver::simplify : we are not in the toplevel!");
+    }
+    if (!_myyura) { return false; }
+
+    CRARef conflict = propagate();
+    if (conflict != CRAREF_UNDEF) {
+        if (_proof != NULL) { proof_empty_clause(conflict); }
+        return _myyura = false;
+    }
+    if (_trail.size() == _simplify_assigns || _n_propagations < _simplify_propagations) { return true; }
+
+    if (lrat()) { proof_units(); }
+    toplevel_simplify_satisfied_clause(_learnts);
+    toplevel_simplify_satisfied_clause(_clauses);
+
+    // No problem clause has an assigned variable any more
+    for (int i = 0; i < _trail.size(); i++) {
+        _occur_lit[_trail[i]].clear();
+        _occur_lit[~_trail[i]].clear();
+    }
+    for (int i = 0; i < _subsumption_removed.size(); i++) {
+        const Clause& c = _ca[_subsumption_removed[i]];
+        for (int k = 0; k < c.size(); k++) {
+            _occur_lit.smudge(c[k]);
+        }
+    }
+    _subsumption_removed.clear();
+    _occur_lit.clean_all();
+
+    uint64_t n_literals = 0;
+    for (int i = 0; i < _clauses.size(); i++) {
+        n_literals += _ca[_clauses[i]].size();
+    }
+    for (int i = 0; i < _learnts.size(); i++) {
+        n_literals += _ca[_learnts[i]].size();
+    }
+    _simplify_assigns = _trail.size();
+    _simplify_propagations = _n_propagations + n_literals;
+
+    check_garbage();
+    return true;
+}